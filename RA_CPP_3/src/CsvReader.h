@@ -0,0 +1,537 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+/**
+ * @class CsvScanner
+ * @brief Разбор CSV-данных на записи и поля (std::string_view поверх исходного буфера).
+ *
+ * Служебные символы (разделитель, кавычка, перевод строки) ищутся блоками по 64 байта
+ * с помощью SIMD-инструкций (AVX2 или SSE2, иначе - скалярный вариант). Найденные позиции
+ * обрабатываются небольшим автоматом, который поддерживает поля в кавычках (RFC 4180):
+ * внутри них разделители и переводы строк - обычные символы, а "" - экранированная кавычка.
+ *
+ * Поле в кавычках отдаётся без обрамляющих кавычек, но с экранированными кавычками как есть
+ * (см. CsvScanner::unescape()). Пустые строки пропускаются, завершающий '\r' отбрасывается.
+ */
+class CsvScanner final
+{
+public:
+    explicit CsvScanner(char delimiter = ',')
+        : delimiter_(delimiter)
+    {}
+
+    /**
+     * @brief Разбирает буфер и передаёт каждую запись (const std::vector<std::string_view>&) в указанную функцию.
+     */
+    template<typename Sink>
+    void scan(std::string_view buffer, Sink&& sink) const
+    {
+        Record<Sink> record(sink, buffer);
+
+        for (size_t block = 0; block < buffer.size(); block += BLOCK_SIZE) {
+            uint64_t mask = structuralMask(buffer.data() + block, std::min(BLOCK_SIZE, buffer.size() - block));
+
+            // NOTE: Перебираем лишь позиции служебных символов, пропуская всё остальное разом.
+            while (mask != 0) {
+                const size_t position = block + countTrailingZeros(mask);
+                mask &= mask - 1;
+
+                record.feed(position);
+            }
+        }
+
+        record.finish();
+    }
+
+    /**
+     * @brief Заменяет экранированные кавычки ("") в значении поля на одинарные.
+     */
+    static std::string unescape(std::string_view field)
+    {
+        std::string result;
+        result.reserve(field.size());
+
+        for (size_t i = 0; i < field.size(); ++i) {
+            result.push_back(field[i]);
+
+            if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') {
+                ++i;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    /**
+     * @class Record
+     * @brief Автомат разбора записей по позициям служебных символов.
+     */
+    template<typename Sink>
+    class Record final
+    {
+    public:
+        Record(Sink& sink, std::string_view buffer)
+            : sink_(sink)
+            , buffer_(buffer)
+        {}
+
+        void feed(size_t position)
+        {
+            const char ch = buffer_[position];
+
+            if (quoted_) {
+                if (ch != '"' || position < skipUntil_) {
+                    return;
+                }
+
+                // NOTE: Две кавычки подряд внутри поля - экранированная кавычка.
+                if (position + 1 < buffer_.size() && buffer_[position + 1] == '"') {
+                    skipUntil_ = position + 2;
+                    return;
+                }
+
+                quoted_ = false;
+                quoteEnd_ = position;
+                return;
+            }
+
+            if (ch == '"') {
+                // NOTE: Кавычка открывает поле, только если стоит в его начале. Иначе это обычный символ.
+                if (position == fieldBegin_) {
+                    quoted_ = true;
+                }
+
+                return;
+            }
+
+            endField(position);
+
+            if (ch == '\n') {
+                endRecord();
+            }
+
+            fieldBegin_ = position + 1;
+            quoteEnd_ = std::string_view::npos;
+        }
+
+        void finish()
+        {
+            // NOTE: Последняя запись может не заканчиваться переводом строки.
+            if (fieldBegin_ < buffer_.size() || !fields_.empty()) {
+                endField(buffer_.size());
+                endRecord();
+            }
+        }
+
+    private:
+        void endField(size_t end)
+        {
+            std::string_view field;
+
+            if (quoteEnd_ != std::string_view::npos) {
+                field = buffer_.substr(fieldBegin_ + 1, quoteEnd_ - fieldBegin_ - 1);
+            } else {
+                field = buffer_.substr(fieldBegin_, end - fieldBegin_);
+
+                if (!field.empty() && field.back() == '\r') {
+                    field.remove_suffix(1);
+                }
+            }
+
+            fields_.push_back(field);
+        }
+
+        void endRecord()
+        {
+            // NOTE: Пустые строки не считаем записями.
+            if (fields_.size() == 1 && fields_.front().empty() && quoteEnd_ == std::string_view::npos) {
+                fields_.clear();
+                return;
+            }
+
+            sink_(fields_);
+            fields_.clear();
+        }
+
+    private:
+        Sink& sink_;
+        std::string_view buffer_;
+        std::vector<std::string_view> fields_;
+        size_t fieldBegin_ = 0;
+        size_t quoteEnd_ = std::string_view::npos; // NOTE: Позиция закрывающей кавычки поля.
+        size_t skipUntil_ = 0;
+        bool quoted_ = false;
+    };
+
+    /**
+     * @brief Возвращает битовую маску служебных символов в блоке (бит i - байт i).
+     */
+    uint64_t structuralMask(const char* data, size_t size) const noexcept
+    {
+        if (size < BLOCK_SIZE) {
+            return scalarMask(data, size);
+        }
+
+#if defined(__AVX2__)
+        const __m256i delimiter = _mm256_set1_epi8(delimiter_);
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i newline = _mm256_set1_epi8('\n');
+
+        uint64_t mask = 0;
+
+        for (size_t offset = 0; offset < BLOCK_SIZE; offset += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            const __m256i matches = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, delimiter), _mm256_cmpeq_epi8(chunk, quote)),
+                _mm256_cmpeq_epi8(chunk, newline)
+            );
+
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(matches))) << offset;
+        }
+
+        return mask;
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128i delimiter = _mm_set1_epi8(delimiter_);
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i newline = _mm_set1_epi8('\n');
+
+        uint64_t mask = 0;
+
+        for (size_t offset = 0; offset < BLOCK_SIZE; offset += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            const __m128i matches = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiter), _mm_cmpeq_epi8(chunk, quote)),
+                _mm_cmpeq_epi8(chunk, newline)
+            );
+
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(matches))) << offset;
+        }
+
+        return mask;
+#else
+        return scalarMask(data, size);
+#endif
+    }
+
+    uint64_t scalarMask(const char* data, size_t size) const noexcept
+    {
+        uint64_t mask = 0;
+
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] == delimiter_ || data[i] == '"' || data[i] == '\n') {
+                mask |= uint64_t(1) << i;
+            }
+        }
+
+        return mask;
+    }
+
+    static size_t countTrailingZeros(uint64_t mask) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+        size_t count = 0;
+
+        while ((mask & 1) == 0) {
+            mask >>= 1;
+            ++count;
+        }
+
+        return count;
+#endif
+    }
+
+private:
+    char delimiter_;
+};
+
+/**
+ * @class CsvReader
+ * @brief Чтение CSV-таблицы в столбцы строк (std::string_view) поверх одного общего буфера.
+ * @warning Буфер должен жить дольше, чем объект CsvReader и полученные из него строки.
+ */
+class CsvReader final
+{
+public:
+    explicit CsvReader(char delimiter = ',')
+        : scanner_(delimiter)
+    {}
+
+    /**
+     * @brief Разбирает указанный буфер, добавляя его записи к уже прочитанным.
+     */
+    void read(std::string_view buffer)
+    {
+        scanner_.scan(buffer, [this](const std::vector<std::string_view>& fields) {
+            append(fields);
+        });
+    }
+
+    size_t rows() const noexcept
+    {
+        return rows_;
+    }
+
+    size_t columns() const noexcept
+    {
+        return columns_.size();
+    }
+
+    /**
+     * @brief Возвращает значения указанного столбца (по одному на каждую запись).
+     */
+    const std::vector<std::string_view>& column(size_t index) const
+    {
+        return columns_.at(index);
+    }
+
+    std::string_view at(size_t row, size_t column) const
+    {
+        return columns_.at(column).at(row);
+    }
+
+private:
+    void append(const std::vector<std::string_view>& fields)
+    {
+        // NOTE: Запись длиннее предыдущих - добавляем столбцы, дополненные пустыми значениями.
+        while (columns_.size() < fields.size()) {
+            columns_.emplace_back(rows_);
+        }
+
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            columns_[i].push_back(i < fields.size() ? fields[i] : std::string_view());
+        }
+
+        ++rows_;
+    }
+
+private:
+    CsvScanner scanner_;
+    size_t rows_ = 0;
+    std::vector<std::vector<std::string_view>> columns_; // NOTE: Таблица хранится по столбцам.
+};
+
+/**
+ * @enum ColumnType
+ * @brief Типы столбцов CSV-таблицы для чтения по схеме.
+ */
+enum class ColumnType
+{
+    Int64,
+    Double,
+    String,
+    Date
+};
+
+/**
+ * @struct Date
+ * @brief Календарная дата в формате YYYY-MM-DD.
+ */
+struct Date final
+{
+    int16_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+
+    bool operator==(const Date& other) const noexcept
+    {
+        return (year == other.year) && (month == other.month) && (day == other.day);
+    }
+};
+
+/**
+ * @class TypedCsvReader
+ * @brief Чтение CSV-таблицы по схеме: каждый столбец разбирается в собственный непрерывный вектор значений.
+ *
+ * Значения разбираются std::from_chars прямо из исходного буфера, без промежуточных строк.
+ * Строковые столбцы хранятся как std::string_view, поэтому буфер должен жить дольше таблицы.
+ * @throw std::runtime_error при несоответствии данных схеме
+ */
+class TypedCsvReader final
+{
+public:
+    using Column = std::variant<std::vector<int64_t>, std::vector<double>, std::vector<std::string_view>, std::vector<Date>>;
+
+    explicit TypedCsvReader(std::vector<ColumnType> schema, char delimiter = ',', bool hasHeader = false)
+        : scanner_(delimiter)
+        , schema_(std::move(schema))
+        , hasHeader_(hasHeader)
+    {
+        for (const ColumnType type : schema_) {
+            columns_.push_back(makeColumn(type));
+        }
+    }
+
+    /**
+     * @brief Разбирает указанный буфер, добавляя его записи к уже прочитанным.
+     */
+    void read(std::string_view buffer)
+    {
+        bool skipHeader = hasHeader_ && (rows_ == 0);
+
+        scanner_.scan(buffer, [this, &skipHeader](const std::vector<std::string_view>& fields) {
+            if (skipHeader) {
+                skipHeader = false;
+                return;
+            }
+
+            append(fields);
+        });
+    }
+
+    size_t rows() const noexcept
+    {
+        return rows_;
+    }
+
+    size_t columns() const noexcept
+    {
+        return columns_.size();
+    }
+
+    /**
+     * @brief Возвращает значения столбца указанного типа.
+     * @tparam T int64_t, double, std::string_view или Date (в соответствии со схемой)
+     * @throw std::bad_variant_access, если тип не соответствует схеме
+     */
+    template<typename T>
+    const std::vector<T>& column(size_t index) const
+    {
+        return std::get<std::vector<T>>(columns_.at(index));
+    }
+
+private:
+    static Column makeColumn(ColumnType type)
+    {
+        switch (type) {
+        case ColumnType::Int64:
+            return std::vector<int64_t>();
+        case ColumnType::Double:
+            return std::vector<double>();
+        case ColumnType::String:
+            return std::vector<std::string_view>();
+        case ColumnType::Date:
+            return std::vector<Date>();
+        }
+
+        throw std::invalid_argument("Unknown column type");
+    }
+
+    void append(const std::vector<std::string_view>& fields)
+    {
+        if (fields.size() != columns_.size()) {
+            throw std::runtime_error("CSV row " + std::to_string(rows_) + ": expected " + std::to_string(columns_.size())
+                + " fields, got " + std::to_string(fields.size()));
+        }
+
+        try {
+            for (size_t i = 0; i < columns_.size(); ++i) {
+                std::visit([this, i, field = fields[i]](auto& values) {
+                    values.push_back(parse<typename std::decay_t<decltype(values)>::value_type>(field, i));
+                }, columns_[i]);
+            }
+        } catch (...) {
+            // NOTE: Откатываем значения, уже добавленные в первые столбцы: длины столбцов должны совпадать с rows().
+            for (Column& column : columns_) {
+                std::visit([this](auto& values) {
+                    values.resize(rows_);
+                }, column);
+            }
+
+            throw;
+        }
+
+        ++rows_;
+    }
+
+    template<typename T>
+    T parse(std::string_view field, size_t column) const
+    {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return field;
+        } else if constexpr (std::is_same_v<T, Date>) {
+            // NOTE: Дата - три числа YYYY-MM-DD, каждое разбираем отдельно. std::from_chars принимает и знак
+            // ("-123-01-01"), поэтому сначала проверяем, что на месте чисел стоят только цифры.
+            Date date;
+
+            if (field.size() == 10 && field[4] == '-' && field[7] == '-'
+                && isDigits(field.substr(0, 4)) && isDigits(field.substr(5, 2)) && isDigits(field.substr(8, 2))
+                && parseNumber(field.substr(0, 4), date.year)
+                && parseNumber(field.substr(5, 2), date.month)
+                && parseNumber(field.substr(8, 2), date.day)
+                && date.month >= 1 && date.month <= 12 && date.day >= 1 && date.day <= daysInMonth(date.year, date.month)) {
+                return date;
+            }
+
+            throw error(field, column);
+        } else {
+            T value{};
+
+            if (!parseNumber(field, value)) {
+                throw error(field, column);
+            }
+
+            return value;
+        }
+    }
+
+    template<typename T>
+    static bool parseNumber(std::string_view field, T& value) noexcept
+    {
+        const char* const end = field.data() + field.size();
+        const auto [ptr, ec] = std::from_chars(field.data(), end, value);
+
+        // NOTE: Значение должно занимать всё поле целиком.
+        return (ec == std::errc()) && (ptr == end);
+    }
+
+    static bool isDigits(std::string_view field) noexcept
+    {
+        return std::all_of(field.begin(), field.end(), [](char symbol) {
+            return symbol >= '0' && symbol <= '9';
+        });
+    }
+
+    /**
+     * @brief Число дней в месяце с учётом високосных лет (григорианский календарь).
+     */
+    static int daysInMonth(int year, int month) noexcept
+    {
+        if (month == 2) {
+            const bool leap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+            return leap ? 29 : 28;
+        }
+
+        return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+    }
+
+    std::runtime_error error(std::string_view field, size_t column) const
+    {
+        return std::runtime_error("CSV row " + std::to_string(rows_) + ", column " + std::to_string(column)
+            + ": invalid value \"" + std::string(field) + "\"");
+    }
+
+private:
+    CsvScanner scanner_;
+    std::vector<ColumnType> schema_;
+    bool hasHeader_;
+    size_t rows_ = 0;
+    std::vector<Column> columns_;
+};
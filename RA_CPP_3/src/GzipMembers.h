@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+/**
+ * @class GzipMembers
+ * @brief Параллельная распаковка многосоставного (multi-member) gzip-архива.
+ *
+ * Ротаторы логов часто дописывают архив новыми членами (каждый - самостоятельный gzip-поток).
+ * Границы членов заранее неизвестны, поэтому сначала ищутся кандидаты - позиции заголовка gzip
+ * (1f 8b 08 и корректный байт флагов). Кандидаты распаковываются параллельно, а затем по цепочке
+ * "конец члена = начало следующего" отбрасываются ложные кандидаты (случайные совпадения внутри сжатых данных).
+ * Распакованные члены отдаются потребителю строго в исходном порядке.
+ *
+ * Заголовок может случайно встретиться и внутри сжатых данных архива из одного члена, поэтому первый член
+ * распаковывается потоково (порциями, без накопления в памяти), и параллельная распаковка начинается, лишь
+ * если он закончился ровно на следующем кандидате.
+ */
+class GzipMembers final
+{
+public:
+    explicit GzipMembers(std::string_view archive)
+        : archive_(archive)
+    {
+        for (size_t position = 0; position + 4 <= archive_.size(); ++position) {
+            position = archive_.find("\x1f\x8b\x08", position, 3);
+
+            if (position == std::string_view::npos) {
+                break;
+            }
+
+            // NOTE: Старшие три бита байта флагов зарезервированы и должны быть нулевыми.
+            if (position + 3 < archive_.size() && (static_cast<uint8_t>(archive_[position + 3]) & 0xE0) == 0) {
+                candidates_.push_back(position);
+            }
+        }
+    }
+
+    /**
+     * @brief Распаковывает архив: первый член - потоково, следующие (если они есть) - в указанное число потоков.
+     * @param consumer функция, получающая распакованные данные (std::string&&) в исходном порядке
+     * @throw std::runtime_error, если архив повреждён
+     */
+    template<typename Consumer>
+    void inflate(size_t threadCount, Consumer&& consumer)
+    {
+        const Inflated first = inflateAt(0, consumer);
+
+        if (!first.valid) {
+            throw std::runtime_error("Corrupted gzip member at offset 0");
+        }
+
+        const auto next = std::lower_bound(candidates_.cbegin(), candidates_.cend(), first.consumed);
+
+        // NOTE: Первый член не закончился на кандидате - архив из одного члена, а остаток считаем мусором
+        // (как и утилита gzip).
+        if (next == candidates_.cend() || *next != first.consumed) {
+            return;
+        }
+
+        inflateMembers(static_cast<size_t>(next - candidates_.cbegin()), threadCount, consumer);
+    }
+
+private:
+    // NOTE: Итог распаковки одного члена.
+    struct Inflated final
+    {
+        bool valid = false;
+        size_t consumed = 0; // NOTE: Сколько сжатых байт занял член (вместе с заголовком и хвостом).
+    };
+
+    // NOTE: Распакованный целиком член, ожидающий потребителя.
+    struct Member final
+    {
+        bool valid = false;
+        size_t consumed = 0;
+        std::string data;
+    };
+
+    /**
+     * @brief Распаковывает члены, начиная с кандидата first, в указанное число потоков.
+     */
+    template<typename Consumer>
+    void inflateMembers(size_t first, size_t threadCount, Consumer& consumer)
+    {
+        // NOTE: Ограничиваем число распакованных, но ещё не потреблённых членов, чтобы не держать в памяти весь лог.
+        const size_t window = 2 * threadCount;
+
+        std::vector<std::optional<Member>> members(candidates_.size());
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::condition_variable progress;
+        size_t nextTask = first;
+        size_t cursor = first; // NOTE: Индекс кандидата, который потребитель ждёт следующим.
+        bool stopped = false;
+
+        std::vector<std::thread> workers;
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([&] {
+                while (true) {
+                    size_t task = 0;
+
+                    {
+                        std::unique_lock lock(mutex);
+                        progress.wait(lock, [&] { return stopped || nextTask < std::min(cursor + window, candidates_.size()); });
+
+                        if (stopped) {
+                            return;
+                        }
+
+                        task = nextTask++;
+                    }
+
+                    Member member = inflateMember(candidates_[task]);
+
+                    {
+                        // NOTE: Результат ложного кандидата, который потребитель уже миновал, просто выбрасываем.
+                        const std::lock_guard lock(mutex);
+
+                        if (task >= cursor) {
+                            members[task] = std::move(member);
+                        }
+                    }
+
+                    ready.notify_all();
+                }
+            });
+        }
+
+        auto stop = [&] {
+            {
+                const std::lock_guard lock(mutex);
+                stopped = true;
+            }
+
+            progress.notify_all();
+            std::for_each(workers.begin(), workers.end(), std::mem_fn(&std::thread::join));
+        };
+
+        try {
+            for (size_t offset = candidates_[first]; offset < archive_.size();) {
+                const auto it = std::lower_bound(candidates_.cbegin(), candidates_.cend(), offset);
+
+                // NOTE: За последним членом нет заголовка - считаем остаток мусором (как и утилита gzip).
+                if (it == candidates_.cend() || *it != offset) {
+                    break;
+                }
+
+                const size_t index = static_cast<size_t>(it - candidates_.cbegin());
+                Member member;
+
+                {
+                    std::unique_lock lock(mutex);
+
+                    // NOTE: Ложные кандидаты между членами больше не нужны, освобождаем их результаты.
+                    for (size_t skipped = cursor; skipped < index; ++skipped) {
+                        members[skipped].reset();
+                    }
+
+                    // NOTE: Ещё не взятых в работу ложных кандидатов пропускаем.
+                    cursor = index;
+                    nextTask = std::max(nextTask, cursor);
+                    progress.notify_all();
+
+                    ready.wait(lock, [&] { return members[index].has_value(); });
+                    member = std::move(*members[index]);
+                    members[index].reset();
+
+                    cursor = index + 1;
+                }
+
+                progress.notify_all();
+
+                if (!member.valid) {
+                    throw std::runtime_error("Corrupted gzip member at offset " + std::to_string(offset));
+                }
+
+                offset += member.consumed;
+                consumer(std::move(member.data));
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+
+        stop();
+    }
+
+    Member inflateMember(size_t offset) const
+    {
+        Member member;
+
+        const Inflated inflated = inflateAt(offset, [&member](std::string&& block) {
+            if (member.data.empty()) {
+                member.data = std::move(block);
+            } else {
+                member.data.append(block);
+            }
+        });
+
+        member.valid = inflated.valid;
+        member.consumed = inflated.consumed;
+
+        if (!member.valid) {
+            member.data = std::string();
+        }
+
+        return member;
+    }
+
+    /**
+     * @brief Распаковывает член, начинающийся со смещения offset, отдавая данные порциями.
+     * @param sink функция, получающая очередную порцию распакованных данных (std::string&&)
+     * @note У повреждённого члена часть данных может быть отдана до обнаружения ошибки.
+     */
+    template<typename Sink>
+    Inflated inflateAt(size_t offset, Sink&& sink) const
+    {
+        constexpr size_t OUTPUT_BLOCK = 1024 * 1024;
+
+        Inflated inflated;
+
+        z_stream stream{};
+
+        // NOTE: 16 + MAX_WBITS - разбирать только формат gzip (заголовок, CRC32 и длину в хвосте).
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+            return inflated;
+        }
+
+        const std::string_view input = archive_.substr(offset);
+
+        // NOTE: zlib принимает размер порции в 32-битном виде, поэтому большие архивы подаём частями.
+        size_t fed = 0;
+        int status = Z_OK;
+
+        std::string block(OUTPUT_BLOCK, '\0');
+        size_t produced = 0;
+
+        try {
+            while (status == Z_OK) {
+                if (stream.avail_in == 0 && fed < input.size()) {
+                    const size_t portion = std::min<size_t>(input.size() - fed, std::numeric_limits<uInt>::max());
+
+                    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + fed));
+                    stream.avail_in = static_cast<uInt>(portion);
+                    fed += portion;
+                }
+
+                stream.next_out = reinterpret_cast<Bytef*>(block.data() + produced);
+                stream.avail_out = static_cast<uInt>(OUTPUT_BLOCK - produced);
+
+                status = ::inflate(&stream, Z_NO_FLUSH);
+                produced = OUTPUT_BLOCK - stream.avail_out;
+
+                if (produced == OUTPUT_BLOCK) {
+                    sink(std::move(block));
+                    block.assign(OUTPUT_BLOCK, '\0');
+                    produced = 0;
+                }
+
+                // NOTE: Входные данные закончились раньше конца члена - это ошибка.
+                if (status == Z_BUF_ERROR && stream.avail_in == 0 && fed == input.size()) {
+                    break;
+                }
+
+                if (status == Z_BUF_ERROR) {
+                    status = Z_OK;
+                }
+            }
+
+            inflated.valid = (status == Z_STREAM_END);
+            inflated.consumed = static_cast<size_t>(stream.total_in);
+
+            if (inflated.valid && produced > 0) {
+                block.resize(produced);
+                sink(std::move(block));
+            }
+        } catch (...) {
+            inflateEnd(&stream);
+            throw;
+        }
+
+        inflateEnd(&stream);
+
+        return inflated;
+    }
+
+private:
+    std::string_view archive_;
+    std::vector<size_t> candidates_;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+using namespace std::chrono;
+
+/**
+ * @class TimeTracker
+ * @brief RAII-класс замера времени жизни области видимости.
+ * @note Если сообщить объём обработанных данных, дополнительно выводится пропускная способность.
+ */
+class TimeTracker final
+{
+public:
+    explicit TimeTracker(std::string_view label)
+        : label_(label)
+        , begin_(steady_clock::now())
+    {}
+
+    ~TimeTracker()
+    {
+        const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - begin_).count();
+
+        std::cout << label_
+                  << ": "
+                  << elapsed
+                  << " ms. elapsed";
+
+        if (bytes_ > 0) {
+            // NOTE: Защищаемся от деления на ноль при слишком быстрой обработке.
+            const double seconds = std::max<double>(elapsed, 1) / 1000.0;
+
+            std::cout << ", "
+                      << static_cast<double>(bytes_) / (1024.0 * 1024.0) / seconds
+                      << " MB/s";
+        }
+
+        std::cout << "\n";
+    }
+
+    /**
+     * @brief Учитывает указанный объём обработанных данных (в байтах).
+     */
+    void addBytes(uint64_t bytes) noexcept
+    {
+        bytes_ += bytes;
+    }
+
+private:
+    std::string label_;
+    std::chrono::steady_clock::time_point begin_;
+    uint64_t bytes_ = 0;
+};
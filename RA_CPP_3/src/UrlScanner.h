@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * @class UrlScanner
+ * @brief Конечный автомат поиска URL-лов в тексте.
+ *
+ * Распознаёт ту же грамматику, что и регулярное выражение
+ * R"(https?:\/\/?([\w\.-]+)(\/[\w\.\,\/\+]*)*\/?)" (std::regex, ECMAScript),
+ * и находит те же самые совпадения, что и std::sregex_iterator.
+ *
+ * Жадные квантификаторы выражения сводятся к поиску самого длинного совпадения:
+ * "http" ["s"] ":/" ["/"] [\w.-]+ ["/" [\w.,/+]*].
+ * Начало кандидата ищется через memchr, остаток разбирается табличным автоматом без аллокаций.
+ */
+class UrlScanner final
+{
+public:
+    explicit UrlScanner(std::string_view text) noexcept
+        : text_(text)
+    {}
+
+    /**
+     * @brief Ищет следующее вхождение URL-а.
+     * @param[out] url найденное совпадение (ссылается на исходный текст)
+     * @return значение, показывающее найдено ли совпадение
+     */
+    bool next(std::string_view& url) noexcept
+    {
+        const char* const end = text_.data() + text_.size();
+
+        while (position_ < text_.size()) {
+            const char* const begin = text_.data() + position_;
+            const char* const candidate = static_cast<const char*>(std::memchr(begin, 'h', static_cast<size_t>(end - begin)));
+
+            if (!candidate) {
+                break;
+            }
+
+            const size_t length = match(candidate, end);
+
+            if (length > 0) {
+                // NOTE: Как и std::sregex_iterator, продолжаем поиск с конца совпадения.
+                position_ = static_cast<size_t>(candidate - text_.data()) + length;
+                url = std::string_view(candidate, length);
+                return true;
+            }
+
+            position_ = static_cast<size_t>(candidate - text_.data()) + 1;
+        }
+
+        position_ = text_.size();
+        return false;
+    }
+
+private:
+    // NOTE: Классы символов, различимые автоматом.
+    enum Class : uint8_t
+    {
+        Other,
+        LetterS,   // 's' (входит в \w, но нужен отдельно для схемы "https")
+        Colon,     // ':'
+        Slash,     // '/'
+        HostOnly,  // '-'
+        PathOnly,  // ',' и '+'
+        Word,      // \w и '.'
+        ClassCount
+    };
+
+    // NOTE: Состояния автомата. Dead - отказ, Host и Path - допускающие.
+    enum State : uint8_t
+    {
+        Dead,
+        Scheme,      // прочитано "http"
+        SchemeS,     // прочитано "https"
+        AfterColon,  // прочитано "http(s):"
+        AfterSlash,  // прочитано "http(s):/"
+        AfterSlash2, // прочитано "http(s)://"
+        Host,
+        Path,
+        StateCount
+    };
+
+    using ClassTable = std::array<uint8_t, 256>;
+    using TransitionTable = std::array<std::array<uint8_t, ClassCount>, StateCount>;
+
+    static constexpr ClassTable makeClasses() noexcept
+    {
+        ClassTable table{};
+
+        // NOTE: \w в локали "C" - это [A-Za-z0-9_].
+        for (int ch = 'a'; ch <= 'z'; ++ch) {
+            table[static_cast<size_t>(ch)] = Word;
+        }
+
+        for (int ch = 'A'; ch <= 'Z'; ++ch) {
+            table[static_cast<size_t>(ch)] = Word;
+        }
+
+        for (int ch = '0'; ch <= '9'; ++ch) {
+            table[static_cast<size_t>(ch)] = Word;
+        }
+
+        table['_'] = Word;
+        table['.'] = Word;
+        table['s'] = LetterS;
+        table[':'] = Colon;
+        table['/'] = Slash;
+        table['-'] = HostOnly;
+        table[','] = PathOnly;
+        table['+'] = PathOnly;
+
+        return table;
+    }
+
+    static constexpr TransitionTable makeTransitions() noexcept
+    {
+        TransitionTable table{};
+
+        table[Scheme][LetterS] = SchemeS;
+        table[Scheme][Colon] = AfterColon;
+        table[SchemeS][Colon] = AfterColon;
+        table[AfterColon][Slash] = AfterSlash;
+        table[AfterSlash][Slash] = AfterSlash2;
+
+        // NOTE: Имя хоста - [\w.-]+.
+        for (const State state : { AfterSlash, AfterSlash2, Host }) {
+            table[state][LetterS] = Host;
+            table[state][HostOnly] = Host;
+            table[state][Word] = Host;
+        }
+
+        // NOTE: Путь - "/" [\w.,/+]*.
+        table[Host][Slash] = Path;
+        table[Path][LetterS] = Path;
+        table[Path][Slash] = Path;
+        table[Path][PathOnly] = Path;
+        table[Path][Word] = Path;
+
+        return table;
+    }
+
+    /**
+     * @brief Пытается сопоставить URL, начинающийся в указанной позиции.
+     * @return длину совпадения или 0, если совпадения нет
+     */
+    static size_t match(const char* begin, const char* end) noexcept
+    {
+        static constexpr ClassTable classes = makeClasses();
+        static constexpr TransitionTable transitions = makeTransitions();
+
+        if (end - begin < 4 || std::memcmp(begin, "http", 4) != 0) {
+            return 0;
+        }
+
+        uint8_t state = Scheme;
+
+        const char* it = begin + 4;
+
+        for (; it != end; ++it) {
+            const uint8_t next = transitions[state][classes[static_cast<uint8_t>(*it)]];
+
+            if (next == Dead) {
+                break;
+            }
+
+            state = next;
+        }
+
+        // NOTE: Из допускающих состояний нет переходов назад, поэтому последнее допускающее состояние - текущее.
+        return (state == Host || state == Path) ? static_cast<size_t>(it - begin) : 0;
+    }
+
+private:
+    std::string_view text_;
+    size_t position_ = 0;
+};
+
+/**
+ * @brief Вызывает функцию для каждого URL-а, найденного в тексте.
+ */
+template<typename Callback>
+void forEachUrl(std::string_view text, Callback&& callback)
+{
+    UrlScanner scanner(text);
+
+    for (std::string_view url; scanner.next(url);) {
+        callback(url);
+    }
+}
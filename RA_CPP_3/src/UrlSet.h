@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class Arena
+ * @brief Простейший "bump"-аллокатор строк.
+ * @note Память выделяется крупными блоками и освобождается только целиком вместе с ареной.
+ */
+class Arena final
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+
+    Arena() = default;
+
+    Arena(const Arena& other) = delete;
+    Arena(Arena&& other) noexcept = default;
+
+    Arena& operator=(const Arena& other) = delete;
+    Arena& operator=(Arena&& other) noexcept = default;
+
+    /**
+     * @brief Копирует строку в арену.
+     * @return представление строки, действительное всё время жизни арены
+     */
+    std::string_view intern(std::string_view string)
+    {
+        if (!current_ || string.size() > capacity_) {
+            // NOTE: Слишком длинные строки получают отдельный блок, чтобы не тратить остаток текущего.
+            if (string.size() > BLOCK_SIZE / 4) {
+                return copy(allocate(string.size()), string);
+            }
+
+            current_ = allocate(BLOCK_SIZE);
+            capacity_ = BLOCK_SIZE;
+        }
+
+        char* const data = current_;
+
+        current_ += string.size();
+        capacity_ -= string.size();
+
+        return copy(data, string);
+    }
+
+    /**
+     * @brief Забирает все блоки другой арены. Строки из неё остаются действительными.
+     */
+    void adopt(Arena&& other)
+    {
+        std::move(other.blocks_.begin(), other.blocks_.end(), std::back_inserter(blocks_));
+
+        other.blocks_.clear();
+        other.current_ = nullptr;
+        other.capacity_ = 0;
+    }
+
+private:
+    char* allocate(size_t size)
+    {
+        blocks_.push_back(std::make_unique<char[]>(size));
+        return blocks_.back().get();
+    }
+
+    static std::string_view copy(char* data, std::string_view string) noexcept
+    {
+        std::memcpy(data, string.data(), string.size());
+        return std::string_view(data, string.size());
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* current_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+/**
+ * @class UrlSet
+ * @brief Множество строк без повторений на основе хеш-таблицы с открытой адресацией.
+ *
+ * Строки хранятся подряд в арене, а таблица содержит лишь их представления (std::string_view)
+ * вместе с хешем. В отличие от std::set<std::string> нет ни узла в куче на каждый элемент,
+ * ни O(log n) сравнений строк при вставке. Упорядочивание выполняется один раз - при выводе.
+ */
+class UrlSet final
+{
+public:
+    UrlSet()
+        : slots_(INITIAL_CAPACITY)
+    {}
+
+    /**
+     * @brief Добавляет строку, если её ещё нет в множестве.
+     * @return значение, показывающее была ли строка добавлена
+     */
+    bool insert(std::string_view string)
+    {
+        const size_t hash = std::hash<std::string_view>()(string);
+        Slot& slot = find(string, hash);
+
+        if (slot.data) {
+            return false;
+        }
+
+        const std::string_view interned = arena_.intern(string);
+        occupy(slot, interned, hash);
+
+        return true;
+    }
+
+    /**
+     * @brief Переносит в множество все строки другого множества.
+     * @note Строки не копируются: вместе с ними забираются блоки арены.
+     */
+    void merge(UrlSet&& other)
+    {
+        for (const Slot& otherSlot : other.slots_) {
+            if (!otherSlot.data) {
+                continue;
+            }
+
+            const std::string_view string(otherSlot.data, otherSlot.size);
+            Slot& slot = find(string, otherSlot.hash);
+
+            if (!slot.data) {
+                occupy(slot, string, otherSlot.hash);
+            }
+        }
+
+        arena_.adopt(std::move(other.arena_));
+        other = UrlSet();
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Возвращает все строки множества в алфавитном порядке.
+     */
+    std::vector<std::string_view> sorted() const
+    {
+        std::vector<std::string_view> result;
+        result.reserve(size_);
+
+        for (const Slot& slot : slots_) {
+            if (slot.data) {
+                result.emplace_back(slot.data, slot.size);
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+
+        return result;
+    }
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 1024;
+
+    // NOTE: Ячейка таблицы. Пустая ячейка - ячейка с нулевым указателем.
+    struct Slot final
+    {
+        const char* data = nullptr;
+        size_t size = 0;
+        size_t hash = 0;
+    };
+
+    /**
+     * @brief Ищет ячейку со строкой либо первую пустую ячейку на пути линейного пробирования.
+     */
+    Slot& find(std::string_view string, size_t hash)
+    {
+        const size_t mask = slots_.size() - 1;
+
+        for (size_t index = hash & mask;; index = (index + 1) & mask) {
+            Slot& slot = slots_[index];
+
+            if (!slot.data) {
+                return slot;
+            }
+
+            // NOTE: Сравниваем строки только при совпадении хешей.
+            if (slot.hash == hash && std::string_view(slot.data, slot.size) == string) {
+                return slot;
+            }
+        }
+    }
+
+    void occupy(Slot& slot, std::string_view string, size_t hash)
+    {
+        slot = Slot{ string.data(), string.size(), hash };
+
+        // NOTE: Поддерживаем заполненность таблицы не выше 50%, чтобы цепочки пробирования были короткими.
+        if (++size_ * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        }
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Slot> slots(capacity);
+        const size_t mask = capacity - 1;
+
+        for (const Slot& slot : slots_) {
+            if (!slot.data) {
+                continue;
+            }
+
+            size_t index = slot.hash & mask;
+
+            while (slots[index].data) {
+                index = (index + 1) & mask;
+            }
+
+            slots[index] = slot;
+        }
+
+        slots_ = std::move(slots);
+    }
+
+private:
+    std::vector<Slot> slots_; // NOTE: Размер таблицы - всегда степень двойки.
+    size_t size_ = 0;
+    Arena arena_;
+};
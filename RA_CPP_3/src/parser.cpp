@@ -1,58 +1,408 @@
-#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
 #include <functional>
 #include <iostream>
-#include <regex>
-#include <set>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
+#include "GzipMembers.h"
+#include "MappedFile.h"
+#include "OutputSink.h"
+#include "TimeTracker.h"
+#include "UrlScanner.h"
+#include "UrlSet.h"
+
 using namespace boost::iostreams;
 
-int main(int argc, char** argv)
+namespace
 {
-    // NOTE: Обрабатываем аргументы командной строки.
-    if (argc < 5) {
-        std::cerr << "Usage: " << argv[0] << " -i <input_file> -o <output_file>" << "\n";
-        return 1;
+    /**
+     * @struct Options
+     * @brief Параметры командной строки.
+     */
+    struct Options final
+    {
+        std::string input;
+        std::string output;
+        size_t threads = 1;
+    };
+
+    /**
+     * @brief Наибольшее число потоков: больше нескольких потоков на ядро разбор не ускоряет,
+     *        а каждый поток держит собственное множество URL-ов.
+     */
+    size_t maxThreads()
+    {
+        return 4 * std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    /**
+     * @return положительное целое число, записанное в строке, или std::nullopt
+     */
+    std::optional<size_t> parseCount(std::string_view text)
+    {
+        size_t count = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+
+        if (error != std::errc() || end != text.data() + text.size() || count == 0) {
+            return std::nullopt;
+        }
+
+        return count;
     }
 
-    // NOTE: Регулярное выражения для поиска URL-лов.
-    static const std::regex re(R"(https?:\/\/?([\w\.-]+)(\/[\w\.\,\/\+]*)*\/?)");
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
 
-    // NOTE: Множество используем для удаления дубликатов и сортировки URL-лов по алфавиту.
-    std::set<std::string> urls;
+        for (int i = 1; i < argc; i += 2) {
+            const std::string_view key = argv[i];
 
-    std::string line;
+            // NOTE: У каждого параметра должно быть значение.
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
 
-    // NOTE: Открываем архив с логами на чтение.
-    std::ifstream file(argv[2], std::ios::in | std::ios::binary);
+            if (key == "-i") {
+                options.input = argv[i + 1];
+            } else if (key == "-o") {
+                options.output = argv[i + 1];
+            } else if (key == "--threads") {
+                const std::optional<size_t> threads = parseCount(argv[i + 1]);
 
-    // NOTE: Устанавливаем буфер потока с распаковкой архива на лету.
-    filtering_streambuf<input> streambuf;
-    streambuf.push(gzip_decompressor());
-    streambuf.push(file);
+                if (!threads || *threads > maxThreads()) {
+                    return std::nullopt;
+                }
 
-    std::istream in(&streambuf);
+                options.threads = *threads;
+            } else {
+                return std::nullopt;
+            }
+        }
 
-    while (std::getline(in, line)) {
-        // NOTE: Для каждой строки собираем все вхождения URL-лов.
-        for (auto it = std::sregex_iterator(line.begin(), line.end(), re); it != std::sregex_iterator(); ++it) {
-            const std::smatch match = *it;
-            urls.insert(match[0]);
+        if (options.input.empty() || options.output.empty()) {
+            return std::nullopt;
         }
+
+        return options;
     }
 
-    file.close();
+    /**
+     * @brief Собирает все вхождения URL-лов в указанном фрагменте текста.
+     * @note Символ '\n' не входит в грамматику URL-а, поэтому совпадения не пересекают границы строк.
+     * Это позволяет не разбивать фрагмент на строки и не копировать их.
+     */
+    void collectUrls(std::string_view text, UrlSet& urls)
+    {
+        forEachUrl(text, [&urls](std::string_view url) {
+            urls.insert(url);
+        });
+    }
+
+    /**
+     * @class ChunkQueue
+     * @brief Ограниченная очередь порций текста между читающим и рабочими потоками.
+     */
+    class ChunkQueue final
+    {
+    public:
+        explicit ChunkQueue(size_t capacity)
+            : capacity_(capacity)
+        {}
+
+        /**
+         * @brief Помещает порцию в очередь. Блокирует читающий поток, если очередь заполнена.
+         */
+        void push(std::string chunk)
+        {
+            std::unique_lock lock(mutex_);
+            notFull_.wait(lock, [this] { return queue_.size() < capacity_; });
+
+            queue_.push(std::move(chunk));
+            notEmpty_.notify_one();
+        }
+
+        /**
+         * @brief Извлекает порцию из очереди.
+         * @return порцию текста или std::nullopt, если данные закончились
+         */
+        std::optional<std::string> pop()
+        {
+            std::unique_lock lock(mutex_);
+            notEmpty_.wait(lock, [this] { return !queue_.empty() || closed_; });
 
-    // NOTE: Открываем выходной файл на запись.
-    std::ofstream out(argv[4], std::ios::out);
+            if (queue_.empty()) {
+                return std::nullopt;
+            }
+
+            std::string chunk = std::move(queue_.front());
+            queue_.pop();
+            notFull_.notify_one();
+
+            return chunk;
+        }
+
+        /**
+         * @brief Сообщает рабочим потокам, что новых данных не будет.
+         */
+        void close()
+        {
+            const std::lock_guard lock(mutex_);
+            closed_ = true;
+            notEmpty_.notify_all();
+        }
 
-    for (const std::string& domain : urls) {
-        out << domain << "\n";
+    private:
+        size_t capacity_;
+        bool closed_ = false;
+        std::queue<std::string> queue_;
+        std::mutex mutex_;
+        std::condition_variable notEmpty_;
+        std::condition_variable notFull_;
+    };
+
+    // NOTE: Последовательный разбор потока построчно в одном потоке.
+    UrlSet parseSequential(std::istream& in, TimeTracker& tt)
+    {
+        UrlSet urls;
+
+        for (std::string line; std::getline(in, line);) {
+            collectUrls(line, urls);
+            tt.addBytes(line.size() + 1);
+        }
+
+        return urls;
     }
 
-    out.close();
+    /**
+     * @class Chunker
+     * @brief Нарезает поступающие фрагменты распакованных данных на порции, выровненные по границам строк.
+     */
+    class Chunker final
+    {
+    public:
+        explicit Chunker(ChunkQueue& queue)
+            : queue_(queue)
+        {}
+
+        /**
+         * @brief Добавляет очередной фрагмент данных.
+         * @note Незавершённая последняя строка фрагмента переносится в следующую порцию.
+         */
+        void append(std::string data)
+        {
+            std::string chunk = std::move(data);
+
+            if (!tail_.empty()) {
+                chunk = std::move(tail_.append(chunk));
+            }
+
+            const size_t position = chunk.rfind('\n');
+
+            if (position == std::string::npos) {
+                tail_ = std::move(chunk);
+                return;
+            }
+
+            tail_.assign(chunk, position + 1);
+            chunk.resize(position + 1);
+
+            queue_.push(std::move(chunk));
+        }
+
+        /**
+         * @brief Отдаёт остаток данных (последнюю строку без перевода строки).
+         */
+        void finish()
+        {
+            if (!tail_.empty()) {
+                queue_.push(std::move(tail_));
+            }
+        }
+
+    private:
+        ChunkQueue& queue_;
+        std::string tail_;
+    };
+
+    // NOTE: Параллельный разбор распакованных данных.
+    // Источник данных отдаёт их фрагментами, фрагменты режутся на порции по границам строк, рабочие потоки ищут в них URL-ы.
+    // Каждый рабочий поток наполняет собственное множество, поэтому синхронизация нужна лишь для очереди.
+    template<typename Source>
+    UrlSet parseParallel(Source&& source, size_t threadCount, TimeTracker& tt)
+    {
+        ChunkQueue queue(2 * threadCount);
+        std::vector<UrlSet> partials(threadCount);
+        std::vector<std::thread> workers;
+
+        auto join = [&queue, &workers] {
+            queue.close();
+            std::for_each(workers.begin(), workers.end(), std::mem_fn(&std::thread::join));
+        };
+
+        try {
+            for (size_t i = 0; i < threadCount; ++i) {
+                workers.emplace_back([&queue, &urls = partials[i]] {
+                    while (std::optional<std::string> chunk = queue.pop()) {
+                        collectUrls(*chunk, urls);
+                    }
+                });
+            }
+        } catch (...) {
+            // NOTE: Поток не удалось создать. Уже созданные нужно дождаться: иначе деструктор std::thread вызовет
+            // std::terminate.
+            join();
+            throw;
+        }
+
+        Chunker chunker(queue);
+
+        try {
+            source([&chunker, &tt](std::string&& data) {
+                tt.addBytes(data.size());
+                chunker.append(std::move(data));
+            });
+        } catch (...) {
+            // NOTE: Прежде чем пробросить ошибку источника дальше, дожидаемся рабочих потоков.
+            join();
+            throw;
+        }
+
+        chunker.finish();
+        join();
+
+        // NOTE: Сливаем частичные результаты в одно множество.
+        UrlSet urls = std::move(partials.front());
+
+        for (auto it = std::next(partials.begin()); it != partials.end(); ++it) {
+            urls.merge(std::move(*it));
+        }
+
+        return urls;
+    }
+
+    // NOTE: Источник данных - gzip-архив: первый член распаковывается потоково, следующие - параллельно.
+    auto membersSource(GzipMembers& members, size_t threadCount)
+    {
+        return [&members, threadCount](auto&& consume) {
+            members.inflate(threadCount, consume);
+        };
+    }
+
+    // NOTE: Разбор несжатого файла, отображённого в память.
+    // Текст делится на равные части по границам строк, каждая часть разбирается своим потоком без копирования.
+    UrlSet parseMapped(std::string_view text, size_t threadCount, TimeTracker& tt)
+    {
+        tt.addBytes(text.size());
+
+        std::vector<UrlSet> partials(threadCount);
+        std::vector<std::thread> workers;
+
+        auto join = [&workers] {
+            std::for_each(workers.begin(), workers.end(), std::mem_fn(&std::thread::join));
+        };
+
+        try {
+            for (size_t i = 0; i < threadCount && !text.empty(); ++i) {
+                const size_t newline = text.find('\n', text.size() / (threadCount - i));
+                const size_t length = (newline == std::string_view::npos) ? text.size() : newline + 1;
+
+                workers.emplace_back([part = text.substr(0, length), &urls = partials[i]] {
+                    collectUrls(part, urls);
+                });
+
+                text.remove_prefix(length);
+            }
+        } catch (...) {
+            // NOTE: Поток не удалось создать - дожидаемся уже созданных (см. parseParallel()).
+            join();
+            throw;
+        }
+
+        join();
+
+        UrlSet urls = std::move(partials.front());
+
+        for (auto it = std::next(partials.begin()); it != partials.end(); ++it) {
+            urls.merge(std::move(*it));
+        }
+
+        return urls;
+    }
+
+    bool isGzip(std::string_view data)
+    {
+        return (data.size() >= 2) && (data[0] == '\x1f') && (data[1] == '\x8b');
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // NOTE: Обрабатываем аргументы командной строки.
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " -i <input_file> -o <output_file> [--threads <1.." << maxThreads() << ">]"
+                  << "\n";
+        return 1;
+    }
+
+    // NOTE: Множество используем для удаления дубликатов. Сортируем URL-ы по алфавиту лишь при выводе.
+    UrlSet urls;
+
+    try {
+        TimeTracker tt("parse (threads: " + std::to_string(options->threads) + ")");
+
+        // NOTE: Отображаем входной файл в память. Несжатый лог разбираем прямо из отображения.
+        const MappedFile mapped(options->input);
+
+        if (!isGzip(mapped.data())) {
+            urls = parseMapped(mapped.data(), options->threads, tt);
+        } else if (options->threads > 1) {
+            // NOTE: Члены многосоставного архива распаковываем параллельно. Архив из одного члена GzipMembers
+            // распакует потоково, не накапливая его в памяти.
+            GzipMembers members(mapped.data());
+            urls = parseParallel(membersSource(members, options->threads), options->threads, tt);
+        } else {
+            // NOTE: Распаковываем архив прямо из отображения: файл повторно не открываем, ведь канал (<(...))
+            // второй раз уже не прочитать.
+            filtering_streambuf<input> streambuf;
+            streambuf.push(gzip_decompressor());
+            streambuf.push(array_source(mapped.data().data(), mapped.data().size()));
+
+            std::istream in(&streambuf);
+            urls = parseSequential(in, tt);
+        }
+    } catch (const std::exception& exception) {
+        // NOTE: Ошибки ввода и повреждённый архив. Выводим информацию о них и завершаем программу.
+        std::cerr << "Error occurred: " << exception.what() << "\n";
+        return 1;
+    }
+
+    try {
+        // NOTE: Строки адресов живут в арене UrlSet, поэтому их не нужно копировать в буфер:
+        // OutputSink собирает лишь ссылки на них и записывает крупными порциями через writev().
+        OutputSink out(options->output, SinkOptions{ SinkOptions::Mode::Gather });
+
+        for (const std::string_view domain : urls.sorted()) {
+            out << domain << "\n";
+        }
+
+        out.close();
+    } catch (const std::exception& exception) {
+        std::cerr << "Error occurred: " << exception.what() << "\n";
+        return 1;
+    }
 
     return 0;
 }
@@ -1,28 +1,15 @@
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <vector>
 
 #include <boost/asio/ip/tcp.hpp>
 
-namespace
-{
-    /**
-     * @brief Разбивает строку на набор подстрок по указанному разделителю.
-     */
-    std::vector<std::string> split(const std::string& string, char delimiter)
-    {
-        std::vector<std::string> result;
+#include "CsvReader.h"
+#include "MappedFile.h"
 
-        std::stringstream sstream(string);
-
-        for (std::string line; std::getline(sstream, line, delimiter);) {
-            result.push_back(std::move(line));
-        }
-
-        return result;
-    }
-}
+#define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
 
 /**
  * @struct Nothing
@@ -36,35 +23,25 @@ struct Nothing final
     }
 };
 
-/**
- * @struct CsvReader
- * @brief Функциональный объект для чтения CSV-файлов.
- */
-struct CsvReader final
-{
-    char delimiter;
-    mutable std::vector<std::vector<std::string>> data; // NOTE: Здесь накапливаем считанную таблицу.
-
-    explicit CsvReader(char delimiter = ',')
-        : delimiter(delimiter)
-    {}
-
-    std::string_view operator()(const std::string& line) const
-    {
-        data.push_back(split(line, delimiter));
-        return line;
-    }
-};
-
 namespace
 {
-    template<typename OStream, typename IStream, typename Transform = Nothing>
+    template<typename OStream, typename IStream, typename Transform = Nothing,
+             REQUIRES(!std::is_same_v<std::decay_t<IStream>, MappedFile>)>
     void transform(OStream&& out, IStream&& in, Transform&& transform = Transform())
     {
         for (std::string line; std::getline(in, line);) {
             out << transform(line) << "\n";
         }
     }
+
+    // NOTE: Перегрузка для файла, отображённого в память. Строки не копируются в std::string.
+    template<typename OStream, typename Transform = Nothing>
+    void transform(OStream&& out, const MappedFile& in, Transform&& transform = Transform())
+    {
+        for (const std::string_view line : in) {
+            out << transform(line) << "\n";
+        }
+    }
 }
 
 int main()
@@ -77,17 +54,34 @@ int main()
     // NOTE: запись текстового файла
     transform(std::ofstream("output.txt"), sstream);
 
-    CsvReader reader;
+    try {
+        // NOTE: Копирование текстового файла через отображение в память
+        transform(std::ofstream("output_mapped.txt"), MappedFile("../src/input.csv"));
 
-    // NOTE: Парсинг CSV-файла
-    transform(std::ofstream("/dev/null"), std::ifstream("../src/input.csv"), reader);
+        // NOTE: Парсинг CSV-файла. Таблица ссылается на отображённый в память файл и не копирует значения.
+        const MappedFile csv("../src/input.csv");
 
-    for (const std::vector<std::string>& row : reader.data) {
-        for (const std::string& string : row) {
-            std::cout << string << "|-|";
+        CsvReader reader;
+        reader.read(csv.data());
+
+        for (size_t row = 0; row < reader.rows(); ++row) {
+            for (size_t column = 0; column < reader.columns(); ++column) {
+                std::cout << reader.at(row, column) << "|-|";
+            }
+
+            std::cout << "\n";
         }
 
-        std::cout << "\n";
+        // NOTE: Чтение CSV-файла по схеме. Возраст сразу разбирается в числа, без промежуточных строк.
+        TypedCsvReader typedReader({ ColumnType::String, ColumnType::String, ColumnType::Int64 });
+        typedReader.read(csv.data());
+
+        const std::vector<int64_t>& ages = typedReader.column<int64_t>(2);
+        std::cout << "Average age: " << std::accumulate(ages.cbegin(), ages.cend(), int64_t(0)) / std::max<int64_t>(ages.size(), 1) << "\n";
+    } catch (const std::exception& exception) {
+        // NOTE: Файл не удалось открыть или отобразить в память: в сообщении есть путь и причина.
+        std::cerr << "Error occurred: " << exception.what() << "\n";
+        return 1;
     }
 
     boost::asio::ip::tcp::iostream socket_stream;
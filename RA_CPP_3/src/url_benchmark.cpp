@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TimeTracker.h"
+#include "UrlScanner.h"
+
+// NOTE: Сравниваем поиск URL-лов регулярным выражением и конечным автоматом на сгенерированном логе.
+
+namespace
+{
+    /**
+     * @return положительное целое число, записанное в строке, или std::nullopt
+     */
+    std::optional<size_t> parseCount(std::string_view text)
+    {
+        size_t count = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+
+        if (error != std::errc() || end != text.data() + text.size() || count == 0) {
+            return std::nullopt;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Генерирует лог доступа с URL-ами (в том числе с пограничными случаями грамматики).
+     */
+    std::string generateLog(size_t lineCount)
+    {
+        static const std::vector<std::string> schemes = { "http://", "https://", "http:/", "https:/", "http:///", "htp://", "https:" };
+        static const std::vector<std::string> hosts = { "example.com", "cdn.static-files.net", "10.0.0.1", "my_host", "-.-" };
+        static const std::vector<std::string> paths = { "", "/", "/index.html", "/a/b,c+d/e.f", "/img//1.png/", "/q?x=1", "/%20" };
+
+        std::mt19937 generator(42);
+
+        auto pick = [&generator](const std::vector<std::string>& values) -> const std::string& {
+            return values[std::uniform_int_distribution<size_t>(0, values.size() - 1)(generator)];
+        };
+
+        std::string log;
+
+        for (size_t i = 0; i < lineCount; ++i) {
+            log += "127.0.0.1 - - [10/Oct/2019:13:55:36 +0300] \"GET ";
+            log += pick(schemes) + pick(hosts) + pick(paths);
+            log += " HTTP/1.1\" 200 " + std::to_string(i) + " \"";
+            log += pick(schemes) + pick(hosts) + pick(paths);
+            log += "\" \"Mozilla/5.0 (X11; Linux x86_64) httphttps://host\"\n";
+        }
+
+        return log;
+    }
+
+    std::vector<std::string_view> regexUrls(std::string_view text)
+    {
+        static const std::regex re(R"(https?:\/\/?([\w\.-]+)(\/[\w\.\,\/\+]*)*\/?)");
+
+        std::vector<std::string_view> urls;
+
+        for (auto it = std::cregex_iterator(text.data(), text.data() + text.size(), re); it != std::cregex_iterator(); ++it) {
+            urls.emplace_back(text.data() + it->position(), static_cast<size_t>(it->length()));
+        }
+
+        return urls;
+    }
+
+    std::vector<std::string_view> scannerUrls(std::string_view text)
+    {
+        std::vector<std::string_view> urls;
+
+        forEachUrl(text, [&urls](std::string_view url) {
+            urls.push_back(url);
+        });
+
+        return urls;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<size_t> lineCount = (argc > 1) ? parseCount(argv[1]) : 100'000;
+
+    if (argc > 2 || !lineCount) {
+        std::cerr << "Usage: " << argv[0] << " [<line_count>]" << "\n";
+        return 1;
+    }
+
+    const std::string log = generateLog(*lineCount);
+
+    std::vector<std::string_view> expected;
+    std::vector<std::string_view> actual;
+
+    {
+        TimeTracker tt("std::regex");
+        tt.addBytes(log.size());
+        expected = regexUrls(log);
+    }
+
+    {
+        TimeTracker tt("UrlScanner");
+        tt.addBytes(log.size());
+        actual = scannerUrls(log);
+    }
+
+    // NOTE: Результаты обязаны совпадать полностью, включая позиции совпадений.
+    const bool equal = std::equal(expected.cbegin(), expected.cend(), actual.cbegin(), actual.cend(),
+        [](std::string_view lhs, std::string_view rhs) {
+            return (lhs.data() == rhs.data()) && (lhs.size() == rhs.size());
+        }
+    );
+
+    if (!equal) {
+        std::cerr << "Results differ: " << expected.size() << " vs " << actual.size() << " matches" << "\n";
+        return 1;
+    }
+
+    std::cout << "Matches: " << actual.size() << "\n";
+
+    return 0;
+}
@@ -1,7 +1,8 @@
 #include <iostream>
 #include <mutex>
 #include <string>
-#include <unordered_map>
+
+#include "HashMap.h"
 
 #define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
 
@@ -26,7 +27,7 @@ public:
     }
 
 private:
-    std::unordered_map<int, std::string> map_;
+    HashMap<int, std::string> map_;
 };
 
 // NOTE: Реализуем потоко-безопасное хранилище путём наследования от шаблонного параметра.
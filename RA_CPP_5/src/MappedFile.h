@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+/**
+ * @class MappedFile
+ * @brief Текстовый файл, отображённый в память (mmap), как последовательность строк.
+ *
+ * Строки отдаются как std::string_view прямо из отображения: без копирования и без аллокаций на каждую строку.
+ * Ядру сообщается о последовательном чтении (madvise(MADV_SEQUENTIAL)), чтобы оно читало файл с опережением.
+ * Каналы (pipe, FIFO, <(...)) отобразить нельзя, и размер их неизвестен: их содержимое, как и на платформах
+ * без mmap, целиком читается в память.
+ */
+class MappedFile final
+{
+public:
+    /**
+     * @class LineIterator
+     * @brief Итератор строк отображённого файла (символ '\n' в строку не входит).
+     */
+    class LineIterator final
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        LineIterator() = default;
+
+        explicit LineIterator(std::string_view text) noexcept
+            : position_(text.data())
+            , end_(text.data() + text.size())
+            , done_(false)
+        {
+            ++*this;
+        }
+
+        reference operator*() const noexcept
+        {
+            return line_;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &line_;
+        }
+
+        LineIterator& operator++() noexcept
+        {
+            // NOTE: Данные закончились. Итератор становится равным концу последовательности.
+            if (position_ == end_) {
+                done_ = true;
+                line_ = std::string_view();
+                return *this;
+            }
+
+            const auto* const found = static_cast<const char*>(std::memchr(position_, '\n', static_cast<size_t>(end_ - position_)));
+            const char* const lineEnd = found ? found : end_;
+
+            line_ = std::string_view(position_, static_cast<size_t>(lineEnd - position_));
+            position_ = found ? lineEnd + 1 : end_;
+
+            return *this;
+        }
+
+        bool operator==(const LineIterator& other) const noexcept
+        {
+            return (done_ == other.done_) && (done_ || line_.data() == other.line_.data());
+        }
+
+        bool operator!=(const LineIterator& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const char* position_ = nullptr;
+        const char* end_ = nullptr;
+        std::string_view line_;
+        bool done_ = true;
+    };
+
+public:
+    /**
+     * @brief Отображает указанный файл в память.
+     * @throw std::system_error, если файл не удалось открыть или отобразить
+     */
+    explicit MappedFile(const std::string& filename)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), filename);
+        }
+
+        struct stat status{};
+
+        if (::fstat(fd, &status) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), filename);
+        }
+
+        if (!S_ISREG(status.st_mode)) {
+            // NOTE: У канала st_size равен 0 - читаем его до конца.
+            try {
+                readAll(fd, filename);
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+
+            ::close(fd);
+            return;
+        }
+
+        size_ = static_cast<size_t>(status.st_size);
+
+        // NOTE: Пустой файл отобразить нельзя, да и не нужно.
+        if (size_ > 0) {
+            void* const data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), filename);
+            }
+
+            data_ = static_cast<const char*>(data);
+
+            // NOTE: Подсказка ядру: читаем последовательно, нужна агрессивная упреждающая подкачка.
+            ::madvise(data, size_, MADV_SEQUENTIAL);
+        }
+
+        // NOTE: Отображение остаётся действительным и после закрытия дескриптора.
+        ::close(fd);
+#else
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+        if (!file) {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), filename);
+        }
+
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    ~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (data_ && data_ != buffer_.data()) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    /**
+     * @brief Возвращает всё содержимое файла.
+     */
+    std::string_view data() const noexcept
+    {
+        return std::string_view(data_, size_);
+    }
+
+    LineIterator begin() const noexcept
+    {
+        return LineIterator(data());
+    }
+
+    LineIterator end() const noexcept
+    {
+        return LineIterator();
+    }
+
+private:
+#if defined(__unix__) || defined(__APPLE__)
+    /**
+     * @brief Читает содержимое дескриптора до конца в buffer_.
+     * @throw std::system_error при ошибке чтения
+     */
+    void readAll(int fd, const std::string& filename)
+    {
+        constexpr size_t BLOCK_SIZE = 1 << 16;
+
+        for (;;) {
+            const size_t used = buffer_.size();
+            buffer_.resize(used + BLOCK_SIZE);
+
+            const ssize_t count = ::read(fd, buffer_.data() + used, BLOCK_SIZE);
+
+            if (count < 0 && errno == EINTR) {
+                buffer_.resize(used);
+                continue;
+            }
+
+            if (count < 0) {
+                throw std::system_error(errno, std::generic_category(), filename);
+            }
+
+            buffer_.resize(used + static_cast<size_t>(count));
+
+            if (count == 0) {
+                break;
+            }
+        }
+
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+#endif
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_; // NOTE: Содержимое, которое не удалось отобразить в память.
+};
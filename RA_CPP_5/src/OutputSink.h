@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#include <cstdio>
+#endif
+
+/**
+ * @struct SinkOptions
+ * @brief Параметры буферизованного вывода.
+ */
+struct SinkOptions final
+{
+    /**
+     * @enum Mode
+     * @brief Способ накопления данных перед записью.
+     */
+    enum class Mode
+    {
+        Buffered, // NOTE: Данные копируются в большой выровненный буфер.
+        Gather    // NOTE: Копирования нет: накапливаются лишь ссылки на данные (iovec), запись - через writev().
+    };
+
+    /**
+     * @enum Sync
+     * @brief Когда сбрасывать данные на диск (fsync).
+     */
+    enum class Sync
+    {
+        Never,
+        OnClose,
+        EveryFlush
+    };
+
+    Mode mode = Mode::Buffered;
+    Sync sync = Sync::Never;
+    size_t flushThreshold = 1024 * 1024; // NOTE: Объём накопленных данных (в байтах), при котором выполняется запись.
+};
+
+/**
+ * @class OutputSink
+ * @brief Файловый поток вывода строк, пишущий крупными порциями в обход форматирования и локалей iostream.
+ *
+ * Можно использовать вместо std::ofstream в transform(): поддерживается лишь вывод строк (operator<<).
+ * @warning В режиме Gather данные, переданные в поток, должны оставаться действительными до ближайшего flush().
+ */
+class OutputSink final
+{
+public:
+    /**
+     * @brief Открывает (создаёт или перезаписывает) указанный файл.
+     * @throw std::system_error, если файл не удалось открыть
+     */
+    explicit OutputSink(const std::string& filename, SinkOptions options = SinkOptions())
+        : options_(options)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), filename);
+        }
+#else
+        file_ = std::fopen(filename.c_str(), "wb");
+
+        if (!file_) {
+            throw std::system_error(errno, std::generic_category(), filename);
+        }
+#endif
+
+        if (options_.mode == SinkOptions::Mode::Buffered) {
+            // NOTE: Буфер выровнен по границе страницы - ядру проще копировать из него данные.
+            capacity_ = (std::max<size_t>(options_.flushThreshold, PAGE_SIZE) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+#if defined(__unix__) || defined(__APPLE__)
+            buffer_.reset(static_cast<char*>(std::aligned_alloc(PAGE_SIZE, capacity_)));
+#else
+            buffer_.reset(static_cast<char*>(std::malloc(capacity_)));
+#endif
+
+            if (!buffer_) {
+                throw std::bad_alloc();
+            }
+        }
+    }
+
+    OutputSink(const OutputSink& other) = delete;
+    OutputSink& operator=(const OutputSink& other) = delete;
+
+    ~OutputSink()
+    {
+        // NOTE: Деструктор не должен выбрасывать исключений. Чтобы узнать об ошибке записи, вызывайте close() явно.
+        try {
+            close();
+        } catch (...) {}
+    }
+
+    /**
+     * @brief Оператор вывода строки в поток.
+     */
+    OutputSink& operator<<(std::string_view data)
+    {
+        if (data.empty()) {
+            return *this;
+        }
+
+        if (options_.mode == SinkOptions::Mode::Gather) {
+            iov_.push_back(iovec{ const_cast<char*>(data.data()), data.size() });
+            pending_ += data.size();
+
+            if (pending_ >= options_.flushThreshold || iov_.size() == MAX_IOV) {
+                flush();
+            }
+
+            return *this;
+        }
+
+        if (data.size() > capacity_ - pending_) {
+            flush();
+
+            // NOTE: То, что не помещается в пустой буфер, пишем напрямую.
+            if (data.size() >= capacity_) {
+                writeAll(data.data(), data.size());
+                return *this;
+            }
+        }
+
+        std::memcpy(buffer_.get() + pending_, data.data(), data.size());
+        pending_ += data.size();
+
+        return *this;
+    }
+
+    /**
+     * @brief Записывает накопленные данные в файл.
+     * @throw std::system_error при ошибке записи
+     */
+    void flush()
+    {
+        if (options_.mode == SinkOptions::Mode::Gather) {
+            writeGather();
+        } else {
+            writeAll(buffer_.get(), pending_);
+        }
+
+        pending_ = 0;
+
+        if (options_.sync == SinkOptions::Sync::EveryFlush) {
+            sync();
+        }
+    }
+
+    /**
+     * @brief Записывает накопленные данные и закрывает файл.
+     * @throw std::system_error при ошибке записи
+     */
+    void close()
+    {
+        if (!isOpen()) {
+            return;
+        }
+
+        // NOTE: Файл закрывается и при ошибке записи: иначе дескриптор остался бы открытым до конца программы.
+        try {
+            flush();
+
+            if (options_.sync == SinkOptions::Sync::OnClose) {
+                sync();
+            }
+        } catch (...) {
+            closeFile();
+            throw;
+        }
+
+        if (closeFile() != 0) {
+            throw std::system_error(errno, std::generic_category(), "close");
+        }
+    }
+
+private:
+    static constexpr size_t PAGE_SIZE = 4096;
+
+#if defined(__unix__) || defined(__APPLE__)
+    static constexpr size_t MAX_IOV = IOV_MAX;
+#else
+    static constexpr size_t MAX_IOV = 1024;
+
+    struct iovec final
+    {
+        void* iov_base;
+        size_t iov_len;
+    };
+#endif
+
+    struct FreeDeleter final
+    {
+        void operator()(char* data) const noexcept
+        {
+            std::free(data);
+        }
+    };
+
+    bool isOpen() const noexcept
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return (fd_ >= 0);
+#else
+        return (file_ != nullptr);
+#endif
+    }
+
+    /**
+     * @return 0, если файл закрыт успешно (иначе причина ошибки - в errno)
+     */
+    int closeFile() noexcept
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return ::close(std::exchange(fd_, -1));
+#else
+        return std::fclose(std::exchange(file_, nullptr));
+#endif
+    }
+
+    void writeAll(const char* data, size_t size)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        while (size > 0) {
+            const ssize_t written = ::write(fd_, data, size);
+
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+#else
+        if (size > 0 && std::fwrite(data, 1, size, file_) != size) {
+            throw std::system_error(errno, std::generic_category(), "fwrite");
+        }
+#endif
+    }
+
+    void writeGather()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        iovec* it = iov_.data();
+        iovec* const end = iov_.data() + iov_.size();
+
+        while (it != end) {
+            const ssize_t written = ::writev(fd_, it, static_cast<int>(end - it));
+
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                throw std::system_error(errno, std::generic_category(), "writev");
+            }
+
+            // NOTE: Запись могла быть частичной. Пропускаем полностью записанные фрагменты и укорачиваем текущий.
+            for (auto remaining = static_cast<size_t>(written); remaining > 0;) {
+                const size_t portion = std::min(remaining, it->iov_len);
+
+                it->iov_base = static_cast<char*>(it->iov_base) + portion;
+                it->iov_len -= portion;
+                remaining -= portion;
+
+                if (it->iov_len == 0) {
+                    ++it;
+                }
+            }
+        }
+#else
+        for (const iovec& io : iov_) {
+            writeAll(static_cast<const char*>(io.iov_base), io.iov_len);
+        }
+#endif
+
+        iov_.clear();
+    }
+
+    void sync()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        // NOTE: Специальные файлы (например, /dev/null) не поддерживают fsync - это не ошибка.
+        if (::fsync(fd_) != 0 && errno != EINVAL && errno != EROFS) {
+            throw std::system_error(errno, std::generic_category(), "fsync");
+        }
+#else
+        std::fflush(file_);
+#endif
+    }
+
+private:
+    SinkOptions options_;
+
+#if defined(__unix__) || defined(__APPLE__)
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+
+    std::unique_ptr<char, FreeDeleter> buffer_;
+    size_t capacity_ = 0;
+    size_t pending_ = 0;
+    std::vector<iovec> iov_;
+};
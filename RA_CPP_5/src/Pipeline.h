@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class BoundedQueue
+ * @brief Ограниченная неблокирующая (lock-free) очередь для одного производителя и одного потребителя.
+ * @note Ёмкость округляется вверх до степени двойки.
+ */
+template<typename T>
+class BoundedQueue final
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+        : buffer_(roundUp(std::max<size_t>(capacity, 2)))
+        , mask_(buffer_.size() - 1)
+    {}
+
+    /**
+     * @brief Помещает значение в очередь.
+     * @return значение, показывающее успешность операции (false - очередь заполнена)
+     */
+    bool tryPush(T& value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - head_.load(std::memory_order_acquire) == buffer_.size()) {
+            return false;
+        }
+
+        buffer_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Извлекает значение из очереди.
+     * @return значение, показывающее успешность операции (false - очередь пуста)
+     */
+    bool tryPop(T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Помещает значение в очередь, ожидая освобождения места (обратное давление на производителя).
+     */
+    void push(T value)
+    {
+        for (size_t attempt = 0; !tryPush(value); ++attempt) {
+            backoff(attempt);
+        }
+    }
+
+    /**
+     * @brief Извлекает значение из очереди, ожидая его появления.
+     */
+    T pop()
+    {
+        T value;
+
+        for (size_t attempt = 0; !tryPop(value); ++attempt) {
+            backoff(attempt);
+        }
+
+        return value;
+    }
+
+private:
+    static size_t roundUp(size_t value)
+    {
+        size_t result = 1;
+
+        while (result < value) {
+            result <<= 1;
+        }
+
+        return result;
+    }
+
+    // NOTE: Сначала уступаем процессор, а при долгом ожидании - засыпаем, чтобы не жечь ядро впустую.
+    static void backoff(size_t attempt)
+    {
+        using namespace std::chrono_literals;
+
+        if (attempt < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(50us);
+        }
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t mask_;
+
+    // NOTE: Разносим индексы по разным кэш-линиям, чтобы производитель и потребитель не мешали друг другу.
+    alignas(64) std::atomic<size_t> head_ = 0;
+    alignas(64) std::atomic<size_t> tail_ = 0;
+};
+
+/**
+ * @struct PipelineOptions
+ * @brief Параметры конвейерного преобразования.
+ */
+struct PipelineOptions final
+{
+    size_t queueDepth = 16;  // NOTE: Ёмкость каждой очереди (в пачках строк).
+    size_t batchSize = 1024; // NOTE: Число строк в пачке.
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+};
+
+namespace
+{
+    /**
+     * @brief Конвейерный вариант функции transform(): чтение, преобразование и запись выполняются одновременно.
+     *
+     * Читающий поток раздаёт пачки строк рабочим потокам по кругу, а пишущий (вызывающий) поток забирает
+     * результаты в том же порядке, поэтому порядок вывода совпадает с порядком ввода. Стадии связаны
+     * ограниченными lock-free очередями: если вывод не успевает, чтение приостанавливается (обратное давление).
+     * Опустевшие пачки возвращаются читающему потоку, и строки и результаты переиспользуют уже выделенную память.
+     *
+     * Функция fill(line, result) заполняет результат строки на месте: объект результата достаётся ей от прошлой
+     * пачки (например, вектор с уже выделенной памятью, который нужно лишь очистить).
+     *
+     * @warning Функция преобразования вызывается из нескольких потоков одновременно и должна быть потокобезопасной.
+     * Результат может ссылаться на строку (например, std::string_view): строка живёт до момента записи.
+     */
+    template<typename Result, typename OStream, typename IStream, typename Fill>
+    void transformPipelinedInto(OStream&& out, IStream&& in, Fill&& fill, const PipelineOptions& options = PipelineOptions())
+    {
+        struct Batch final
+        {
+            std::vector<std::string> lines;
+            size_t size = 0;
+            std::vector<Result> results;
+        };
+
+        using BatchPtr = std::unique_ptr<Batch>;
+        using Queue = BoundedQueue<BatchPtr>;
+
+        const size_t workerCount = std::max<size_t>(options.workers, 1);
+        const size_t batchSize = std::max<size_t>(options.batchSize, 1);
+
+        std::vector<std::unique_ptr<Queue>> inputs;
+        std::vector<std::unique_ptr<Queue>> outputs;
+
+        for (size_t i = 0; i < workerCount; ++i) {
+            inputs.push_back(std::make_unique<Queue>(options.queueDepth));
+            outputs.push_back(std::make_unique<Queue>(options.queueDepth));
+        }
+
+        // NOTE: Очередь возврата пустых пачек от пишущего потока читающему.
+        Queue recycled(options.queueDepth * workerCount * 2);
+
+        std::atomic<bool> failed = false;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto fail = [&] {
+            const std::lock_guard lock(errorMutex);
+
+            if (!error) {
+                error = std::current_exception();
+            }
+
+            failed.store(true, std::memory_order_release);
+        };
+
+        // NOTE: Стадия чтения. Пустой указатель - признак конца данных.
+        std::thread reader([&] {
+            size_t index = 0;
+
+            try {
+                for (bool more = true; more && !failed.load(std::memory_order_acquire);) {
+                    BatchPtr batch;
+
+                    if (!recycled.tryPop(batch)) {
+                        batch = std::make_unique<Batch>();
+                        batch->lines.resize(batchSize);
+                    }
+
+                    for (batch->size = 0; batch->size < batchSize; ++batch->size) {
+                        if (!std::getline(in, batch->lines[batch->size])) {
+                            more = false;
+                            break;
+                        }
+                    }
+
+                    if (batch->size > 0) {
+                        inputs[index++ % workerCount]->push(std::move(batch));
+                    }
+                }
+            } catch (...) {
+                fail();
+            }
+
+            for (size_t i = 0; i < workerCount; ++i) {
+                inputs[(index + i) % workerCount]->push(nullptr);
+            }
+        });
+
+        // NOTE: Стадия преобразования.
+        std::vector<std::thread> workers;
+
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back([&, i] {
+                while (BatchPtr batch = inputs[i]->pop()) {
+                    try {
+                        batch->results.resize(batch->size);
+
+                        if (!failed.load(std::memory_order_acquire)) {
+                            for (size_t line = 0; line < batch->size; ++line) {
+                                fill(std::as_const(batch->lines[line]), batch->results[line]);
+                            }
+                        }
+                    } catch (...) {
+                        fail();
+                    }
+
+                    outputs[i]->push(std::move(batch));
+                }
+
+                outputs[i]->push(nullptr);
+            });
+        }
+
+        // NOTE: Стадия записи выполняется в вызывающем потоке в том же порядке, в каком пачки раздавались.
+        size_t index = 0;
+
+        for (BatchPtr batch; (batch = outputs[index % workerCount]->pop()); ++index) {
+            try {
+                if (!failed.load(std::memory_order_acquire)) {
+                    for (const Result& result : batch->results) {
+                        out << result << "\n";
+                    }
+                }
+            } catch (...) {
+                fail();
+            }
+
+            recycled.tryPush(batch);
+        }
+
+        // NOTE: Дочитываем признаки конца данных у остальных рабочих потоков.
+        for (size_t i = 1; i < workerCount; ++i) {
+            outputs[(index + i) % workerCount]->pop();
+        }
+
+        reader.join();
+        std::for_each(workers.begin(), workers.end(), std::mem_fn(&std::thread::join));
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief То же, что transformPipelinedInto(), для функции, возвращающей результат строки: transform(line).
+     */
+    template<typename OStream, typename IStream, typename Transform>
+    void transformPipelined(OStream&& out, IStream&& in, Transform&& transform, const PipelineOptions& options = PipelineOptions())
+    {
+        using Result = std::decay_t<std::invoke_result_t<Transform&, const std::string&>>;
+
+        transformPipelinedInto<Result>(std::forward<OStream>(out), std::forward<IStream>(in),
+            [&transform](const std::string& line, Result& result) {
+                result = transform(line);
+            },
+            options);
+    }
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#include "MappedFile.h"
+
+/**
+ * @class ReadLines
+ * @brief Последовательность (C++20 input range) строк файла без копирования.
+ *
+ * Строки отдаются как std::string_view: либо прямо из области памяти (например, отображённого файла),
+ * либо из большого блочного буфера, который заполняется чтением из файлового дескриптора и переиспользуется.
+ * Символ '\n' в строку не входит. Конец последовательности - std::default_sentinel.
+ *
+ * @warning При чтении из дескриптора строка действительна лишь до перехода к следующей.
+ */
+class ReadLines final
+{
+public:
+    /**
+     * @class Iterator
+     * @brief Итератор строк. Продвигает общую для всех итераторов позицию чтения (однопроходный).
+     */
+    class Iterator final
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        explicit Iterator(ReadLines* lines)
+            : lines_(lines)
+        {
+            ++*this;
+        }
+
+        std::string_view operator*() const noexcept
+        {
+            return line_;
+        }
+
+        Iterator& operator++()
+        {
+            // NOTE: Строки закончились. Итератор становится равным концу последовательности.
+            if (!lines_->next(line_)) {
+                lines_ = nullptr;
+            }
+
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        // NOTE: Конец определяется без сравнения содержимого строк - лишь по состоянию итератора.
+        bool operator==(std::default_sentinel_t) const noexcept
+        {
+            return (lines_ == nullptr);
+        }
+
+    private:
+        ReadLines* lines_ = nullptr;
+        std::string_view line_;
+    };
+
+public:
+    /**
+     * @brief Последовательность строк области памяти.
+     */
+    explicit ReadLines(std::string_view region) noexcept
+        : position_(region.data())
+        , end_(region.data() + region.size())
+        , eof_(true)
+    {}
+
+    explicit ReadLines(const MappedFile& file) noexcept
+        : ReadLines(file.data())
+    {}
+
+    // NOTE: Временный MappedFile будет закрыт раньше, чем прочитаны строки.
+    explicit ReadLines(const MappedFile&& file) = delete;
+
+    /**
+     * @brief Последовательность строк, читаемых из файлового дескриптора блоками указанного размера.
+     * @note Дескриптор не закрывается. Если строка длиннее блока, буфер увеличивается.
+     */
+    explicit ReadLines(int fd, size_t blockSize = 1024 * 1024)
+        : fd_(fd)
+        , buffer_(std::max<size_t>(blockSize, 1))
+        , position_(buffer_.data())
+        , end_(buffer_.data())
+    {}
+
+    ReadLines(const ReadLines& other) = delete;
+    ReadLines& operator=(const ReadLines& other) = delete;
+
+    /**
+     * @throw std::system_error при ошибке чтения
+     */
+    Iterator begin()
+    {
+        return Iterator(this);
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+
+private:
+    bool next(std::string_view& line)
+    {
+        // NOTE: Недочитанная часть строки уже просмотрена, повторно в ней '\n' не ищем.
+        const char* from = position_;
+
+        while (true) {
+            const auto* const found = (from != end_)
+                ? static_cast<const char*>(std::memchr(from, '\n', static_cast<size_t>(end_ - from)))
+                : nullptr;
+
+            if (found) {
+                line = std::string_view(position_, static_cast<size_t>(found - position_));
+                position_ = found + 1;
+                return true;
+            }
+
+            if (eof_) {
+                // NOTE: Последняя строка может не заканчиваться символом '\n'.
+                if (position_ == end_) {
+                    return false;
+                }
+
+                line = std::string_view(position_, static_cast<size_t>(end_ - position_));
+                position_ = end_;
+                return true;
+            }
+
+            const size_t scanned = static_cast<size_t>(end_ - position_);
+
+            fill();
+            from = position_ + scanned;
+        }
+    }
+
+    // NOTE: Переносим недочитанную строку в начало буфера и дочитываем за ней следующий блок.
+    void fill()
+    {
+        const size_t pending = static_cast<size_t>(end_ - position_);
+
+        std::memmove(buffer_.data(), position_, pending);
+
+        if (pending == buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);
+        }
+
+        size_t size = pending;
+
+        while (true) {
+#if defined(__unix__) || defined(__APPLE__)
+            const ssize_t count = ::read(fd_, buffer_.data() + size, buffer_.size() - size);
+#else
+            const int count = ::_read(fd_, buffer_.data() + size, static_cast<unsigned>(buffer_.size() - size));
+#endif
+
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count < 0) {
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+
+            eof_ = (count == 0);
+            size += static_cast<size_t>(count);
+            break;
+        }
+
+        position_ = buffer_.data();
+        end_ = buffer_.data() + size;
+    }
+
+private:
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    const char* position_ = nullptr;
+    const char* end_ = nullptr;
+    bool eof_ = false;
+};
+
+static_assert(std::ranges::input_range<ReadLines>);
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.h"
+
+#define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
+
+struct Nothing
+{
+    constexpr std::string_view operator()(std::string_view line) const noexcept
+    {
+        return line;
+    }
+};
+
+/**
+ * @class RangeStream
+ * @brief Stream-подобная обёртка над парой итераторов ввода (последовательностью).
+ */
+template<typename InputIterator, REQUIRES(std::is_same_v<std::string, typename std::iterator_traits<InputIterator>::value_type>)>
+class RangeStream final
+{
+public:
+    explicit RangeStream(InputIterator begin, InputIterator end)
+        : begin_(std::move(begin))
+        , end_(std::move(end))
+    {}
+
+    /**
+     * @brief Показывает, достигнут ли конец потока (последовательности).
+     */
+    bool eof() const
+    {
+        return (begin_ == end_);
+    }
+
+    /**
+     * @brief Оператор чтения строк из потока.
+     */
+    RangeStream& operator>>(std::string& line)
+    {
+        line = *begin_++;
+        return *this;
+    }
+
+private:
+    InputIterator begin_;
+    InputIterator end_;
+};
+
+template<typename Container, typename = void>
+struct HasTransparentCompare : std::false_type {};
+
+template<typename Container>
+struct HasTransparentCompare<Container, std::void_t<typename Container::key_compare::is_transparent>> : std::true_type {};
+
+/**
+ * @class InsertStream
+ * @brief Stream-подобная обёртка над контейнером: всё, что "выводится" в поток, вставляется в контейнер.
+ * @note Пара для RangeStream. Разделители строк игнорируются.
+ */
+template<typename Container>
+class InsertStream final
+{
+public:
+    explicit InsertStream(Container& container)
+        : container_(container)
+    {}
+
+    /**
+     * @brief Оператор вывода набора значений в поток (вставка в контейнер).
+     */
+    InsertStream& operator<<(const std::vector<std::string_view>& values)
+    {
+        for (const std::string_view value : values) {
+            // NOTE: emplace() создаёт узел (и строку) ещё до поиска. Если контейнер умеет искать по std::string_view
+            // (std::less<>), сначала ищем: повторяющееся значение тогда не выделяет памяти.
+            if constexpr (HasTransparentCompare<Container>::value) {
+                const auto it = container_.lower_bound(value);
+
+                if (it == container_.end() || container_.key_comp()(value, *it)) {
+                    container_.emplace_hint(it, value);
+                }
+            } else {
+                container_.emplace(value);
+            }
+        }
+
+        return *this;
+    }
+
+    InsertStream& operator<<(std::string_view)
+    {
+        return *this;
+    }
+
+private:
+    Container& container_;
+};
+
+// WARNING: Этот "грязный хак" исключительно для примера. Не повторяйте в домашних условиях!
+// std::getline использовать хочется, а наследовать от std::istream - нет.
+namespace std
+{
+    template<typename InputIterator>
+    bool getline(RangeStream<InputIterator>& in, std::string& line)
+    {
+        const bool isEof = in.eof();
+
+        if (!isEof) {
+            in >> line;
+        }
+
+        return !isEof;
+    }
+}
+
+namespace
+{
+    template<typename OStream, typename IStream, typename Transform = Nothing,
+             REQUIRES(!std::is_same_v<std::decay_t<IStream>, MappedFile>)>
+    void transform(OStream&& out, IStream&& in, Transform&& transform = Transform())
+    {
+        for (std::string line; std::getline(in, line);) {
+            out << transform(line) << "\n";
+        }
+    }
+
+    // NOTE: Перегрузка для файла, отображённого в память. Строки не копируются в std::string.
+    template<typename OStream, typename Transform = Nothing>
+    void transform(OStream&& out, const MappedFile& in, Transform&& transform = Transform())
+    {
+        for (const std::string_view line : in) {
+            out << transform(line) << "\n";
+        }
+    }
+}
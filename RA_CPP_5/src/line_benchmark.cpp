@@ -0,0 +1,511 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#include "CsvReader.h"
+#include "MappedFile.h"
+#include "Pipeline.h"
+#include "ReadLines.h"
+#include "Transform.h"
+#include "UrlScanner.h"
+
+// NOTE: Замеры пропускной способности построчной обработки (строк и байт в секунду) на сгенерированных данных.
+// Результаты выводятся таблицей или (с ключом --json) в формате JSON, чтобы отслеживать регрессии.
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Параметры генерации данных и замеров.
+     */
+    struct Options final
+    {
+        size_t size = 64 * 1024 * 1024; // NOTE: Объём каждого набора данных (в байтах).
+        size_t lineLength = 120;        // NOTE: Средняя длина строки.
+        std::string distribution = "exponential";
+        size_t repeat = 5;              // NOTE: Берётся лучший из повторов.
+        std::optional<std::string> json;
+    };
+
+    /**
+     * @return положительное целое число, записанное в строке, или std::nullopt
+     */
+    std::optional<size_t> parseCount(std::string_view text)
+    {
+        size_t count = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+
+        if (error != std::errc() || end != text.data() + text.size() || count == 0) {
+            return std::nullopt;
+        }
+
+        return count;
+    }
+
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view key = argv[i];
+
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            const std::string value = argv[++i];
+
+            if (key == "--size") {
+                constexpr size_t MIB = 1024 * 1024;
+                const std::optional<size_t> size = parseCount(value);
+
+                // NOTE: Пустые данные дали бы деление на ноль в пропускной способности.
+                if (!size || *size > std::numeric_limits<size_t>::max() / MIB) {
+                    return std::nullopt;
+                }
+
+                options.size = *size * MIB;
+            } else if (key == "--line-length") {
+                const std::optional<size_t> lineLength = parseCount(value);
+
+                if (!lineLength) {
+                    return std::nullopt;
+                }
+
+                options.lineLength = *lineLength;
+            } else if (key == "--distribution" && (value == "fixed" || value == "uniform" || value == "exponential")) {
+                options.distribution = value;
+            } else if (key == "--repeat") {
+                const std::optional<size_t> repeat = parseCount(value);
+
+                if (!repeat) {
+                    return std::nullopt;
+                }
+
+                options.repeat = *repeat;
+            } else if (key == "--json") {
+                options.json = value;
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        return options;
+    }
+
+    /**
+     * @class LineLengths
+     * @brief Генератор длин строк с заданным средним и распределением.
+     */
+    class LineLengths final
+    {
+    public:
+        LineLengths(const Options& options, std::mt19937& generator)
+            : options_(options)
+            , generator_(generator)
+        {}
+
+        size_t operator()()
+        {
+            const auto mean = static_cast<double>(options_.lineLength);
+
+            if (options_.distribution == "uniform") {
+                return std::uniform_int_distribution<size_t>(1, 2 * options_.lineLength - 1)(generator_);
+            }
+
+            if (options_.distribution == "exponential") {
+                // NOTE: Много коротких строк и редкие очень длинные - типичная картина для логов.
+                return 1 + static_cast<size_t>(std::exponential_distribution<double>(1.0 / mean)(generator_));
+            }
+
+            return options_.lineLength;
+        }
+
+    private:
+        const Options& options_;
+        std::mt19937& generator_;
+    };
+
+    /**
+     * @brief Генерирует лог: строки из слов, среди которых встречаются URL-ы.
+     */
+    std::string generateLog(const Options& options)
+    {
+        static const std::vector<std::string> words = {
+            "GET", "POST", "200", "404", "-", "[10/Oct/2019:13:55:36", "+0300]", "HTTP/1.1", "Mozilla/5.0", "(X11;", "Linux",
+            "http://example.com/index.html", "https://cdn.static-files.net/img/1.png", "http://10.0.0.1/a/b,c+d/e.f"
+        };
+
+        std::mt19937 generator(42);
+        LineLengths lengths(options, generator);
+        std::uniform_int_distribution<size_t> pick(0, words.size() - 1);
+
+        std::string log;
+        log.reserve(options.size + 4096);
+
+        while (log.size() < options.size) {
+            const size_t length = lengths();
+            const size_t begin = log.size();
+
+            while (log.size() - begin < length) {
+                log += words[pick(generator)];
+                log += ' ';
+            }
+
+            log.resize(begin + length);
+            log += '\n';
+        }
+
+        return log;
+    }
+
+    /**
+     * @brief Генерирует CSV-данные: числа, строки и поля в кавычках (с разделителями и кавычками внутри).
+     */
+    std::string generateCsv(const Options& options)
+    {
+        std::mt19937 generator(42);
+        LineLengths lengths(options, generator);
+        std::uniform_int_distribution<int> number(0, 1'000'000);
+
+        std::string csv = "id,name,comment,value\n";
+        csv.reserve(options.size + 4096);
+
+        for (size_t row = 0; csv.size() < options.size; ++row) {
+            csv += std::to_string(row);
+            csv += ",user";
+            csv += std::to_string(number(generator));
+            csv += ",\"";
+
+            // NOTE: Длина строки задаётся длиной поля в кавычках.
+            const size_t length = lengths();
+
+            for (size_t i = 0; i < length; ++i) {
+                csv += (i % 16 == 7) ? "," : (i % 64 == 31) ? "\"\"" : "x";
+            }
+
+            csv += "\",";
+            csv += std::to_string(number(generator));
+            csv += '\n';
+        }
+
+        return csv;
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& data)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path.string());
+        }
+    }
+
+    int openFile(const std::filesystem::path& path)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+#else
+        const int fd = ::_wopen(path.c_str(), _O_RDONLY | _O_BINARY);
+#endif
+
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+
+        return fd;
+    }
+
+    void closeFile(int fd)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        ::close(fd);
+#else
+        ::_close(fd);
+#endif
+    }
+
+    /**
+     * @class NullStream
+     * @brief Поток вывода, отбрасывающий данные (учитывается лишь их объём, чтобы компилятор не выбросил работу).
+     */
+    class NullStream final
+    {
+    public:
+        explicit NullStream(size_t& bytes)
+            : bytes_(bytes)
+        {}
+
+        NullStream& operator<<(std::string_view data) noexcept
+        {
+            bytes_ += data.size();
+            return *this;
+        }
+
+    private:
+        size_t& bytes_;
+    };
+
+    /**
+     * @struct Result
+     * @brief Результат замера.
+     */
+    struct Result final
+    {
+        std::string name;
+        size_t lines = 0;
+        size_t bytes = 0;
+        double seconds = 0;
+    };
+
+    /**
+     * @brief Выполняет замер несколько раз и возвращает лучший результат.
+     * @param body функция, выполняющая обработку и возвращающая число обработанных строк
+     */
+    Result measure(std::string name, size_t bytes, size_t repeat, const std::function<size_t()>& body)
+    {
+        Result result{ std::move(name), 0, bytes, 0 };
+
+        for (size_t i = 0; i < repeat; ++i) {
+            const auto begin = std::chrono::steady_clock::now();
+            const size_t lines = body();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+            if (i == 0 || elapsed.count() < result.seconds) {
+                result.seconds = elapsed.count();
+            }
+
+            result.lines = lines;
+        }
+
+        std::cerr << "  " << result.name << ": done" << "\n";
+
+        return result;
+    }
+
+    void printTable(std::ostream& out, const std::vector<Result>& results)
+    {
+        out << std::left << std::setw(24) << "benchmark"
+            << std::right << std::setw(12) << "time, ms"
+            << std::setw(16) << "lines/s"
+            << std::setw(14) << "MB/s" << "\n";
+
+        for (const Result& result : results) {
+            out << std::left << std::setw(24) << result.name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << result.seconds * 1000.0
+                << std::setprecision(0)
+                << std::setw(16) << static_cast<double>(result.lines) / result.seconds
+                << std::setprecision(1)
+                << std::setw(14) << static_cast<double>(result.bytes) / (1024.0 * 1024.0) / result.seconds << "\n";
+        }
+    }
+
+    void printJson(std::ostream& out, const Options& options, const std::vector<Result>& results)
+    {
+        out << "{\n"
+            << "  \"context\": {\n"
+            << "    \"size\": " << options.size << ",\n"
+            << "    \"line_length\": " << options.lineLength << ",\n"
+            << "    \"distribution\": \"" << options.distribution << "\",\n"
+            << "    \"repeat\": " << options.repeat << "\n"
+            << "  },\n"
+            << "  \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+
+            out << std::fixed << std::setprecision(3)
+                << "    {\n"
+                << "      \"name\": \"" << result.name << "\",\n"
+                << "      \"lines\": " << result.lines << ",\n"
+                << "      \"bytes\": " << result.bytes << ",\n"
+                << "      \"real_time_ms\": " << result.seconds * 1000.0 << ",\n"
+                << "      \"lines_per_second\": " << static_cast<double>(result.lines) / result.seconds << ",\n"
+                << "      \"bytes_per_second\": " << static_cast<double>(result.bytes) / result.seconds << "\n"
+                << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n"
+            << "}\n";
+    }
+
+    using Urls = std::vector<std::string_view>;
+
+    // NOTE: Как и в Parser, вектор совпадений заполняется на месте и переиспользуется от строки к строке.
+    void collectUrls(std::string_view line, Urls& urls)
+    {
+        urls.clear();
+
+        forEachUrl(line, [&urls](std::string_view url) {
+            urls.push_back(url);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--size <MiB>] [--line-length <mean>] [--distribution fixed|uniform|exponential]"
+                  << " [--repeat <count>] [--json <file>]" << "\n";
+        return 1;
+    }
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path logPath = directory / "line_benchmark.log";
+    const std::filesystem::path csvPath = directory / "line_benchmark.csv";
+
+    std::vector<Result> results;
+
+    try {
+        std::cerr << "Generating data..." << "\n";
+
+        const std::string log = generateLog(*options);
+        const std::string csv = generateCsv(*options);
+        writeFile(logPath, log);
+        writeFile(csvPath, csv);
+
+        const size_t repeat = options->repeat;
+
+        results.push_back(measure("transform/istream", log.size(), repeat, [&] {
+            std::ifstream file(logPath, std::ios::in | std::ios::binary);
+            size_t bytes = 0;
+            size_t lines = 0;
+
+            transform(NullStream(bytes), file, [&lines](const std::string& line) -> const std::string& {
+                ++lines;
+                return line;
+            });
+
+            return lines;
+        }));
+
+        results.push_back(measure("transform/mapped", log.size(), repeat, [&] {
+            const MappedFile file(logPath.string());
+            size_t bytes = 0;
+            size_t lines = 0;
+
+            transform(NullStream(bytes), file, [&lines](std::string_view line) {
+                ++lines;
+                return line;
+            });
+
+            return lines;
+        }));
+
+        results.push_back(measure("ReadLines/fd", log.size(), repeat, [&] {
+            const int fd = openFile(logPath);
+            size_t bytes = 0;
+            size_t lines = 0;
+
+            for (const std::string_view line : ReadLines(fd)) {
+                bytes += line.size();
+                ++lines;
+            }
+
+            closeFile(fd);
+
+            return lines;
+        }));
+
+        results.push_back(measure("ReadLines/mapped", log.size(), repeat, [&] {
+            const MappedFile file(logPath.string());
+            size_t bytes = 0;
+            size_t lines = 0;
+
+            for (const std::string_view line : ReadLines(file)) {
+                bytes += line.size();
+                ++lines;
+            }
+
+            return lines;
+        }));
+
+        results.push_back(measure("CsvReader", csv.size(), repeat, [&] {
+            const MappedFile file(csvPath.string());
+            CsvReader reader;
+
+            reader.read(file.data());
+
+            return reader.rows();
+        }));
+
+        results.push_back(measure("Parser/mapped", log.size(), repeat, [&] {
+            const MappedFile file(logPath.string());
+            std::set<std::string, std::less<>> domains;
+            size_t lines = 0;
+            Urls urls;
+
+            transform(InsertStream(domains), file, [&lines, &urls](std::string_view line) -> const Urls& {
+                ++lines;
+                collectUrls(line, urls);
+                return urls;
+            });
+
+            return lines;
+        }));
+
+        results.push_back(measure("Parser/pipelined", log.size(), repeat, [&] {
+            std::ifstream file(logPath, std::ios::in | std::ios::binary);
+            std::set<std::string, std::less<>> domains;
+            std::atomic<size_t> lines = 0;
+
+            transformPipelinedInto<Urls>(InsertStream(domains), file, [&lines](std::string_view line, Urls& urls) {
+                lines.fetch_add(1, std::memory_order_relaxed);
+                collectUrls(line, urls);
+            });
+
+            return lines.load();
+        }));
+    } catch (const std::exception& exception) {
+        std::cerr << "Error occurred: " << exception.what() << "\n";
+        std::filesystem::remove(logPath);
+        std::filesystem::remove(csvPath);
+        return 1;
+    }
+
+    std::filesystem::remove(logPath);
+    std::filesystem::remove(csvPath);
+
+    // NOTE: "--json -" - вывод JSON вместо таблицы на стандартный вывод.
+    if (options->json == "-") {
+        printJson(std::cout, *options, results);
+        return 0;
+    }
+
+    if (options->json) {
+        std::ofstream file(*options->json, std::ios::out);
+        printJson(file, *options, results);
+    }
+
+    printTable(std::cout, results);
+
+    return 0;
+}
@@ -1,84 +1,26 @@
-#include <fstream>
 #include <functional>
 #include <iostream>
-#include <regex>
 #include <set>
+#include <vector>
 
+#include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
-#define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
+#include "MappedFile.h"
+#include "OutputSink.h"
+#include "Pipeline.h"
+#include "Transform.h"
+#include "UrlScanner.h"
 
 using namespace boost::iostreams;
 
-struct Nothing
-{
-    constexpr std::string_view operator()(std::string_view line) const noexcept
-    {
-        return line;
-    }
-};
-
-/**
- * @class RangeStream
- * @brief Stream-подобная обёртка над парой итераторов ввода (последовательностью).
- */
-template<typename InputIterator, REQUIRES(std::is_same_v<std::string, typename std::iterator_traits<InputIterator>::value_type>)>
-class RangeStream final
-{
-public:
-    explicit RangeStream(InputIterator begin, InputIterator end)
-        : begin_(std::move(begin))
-        , end_(std::move(end))
-    {}
-
-    /**
-     * @brief Показывает, достигнут ли конец потока (последовательности).
-     */
-    bool eof() const
-    {
-        return (begin_ == end_);
-    }
-
-    /**
-     * @brief Оператор чтения строк из потока.
-     */
-    RangeStream& operator>>(std::string& line)
-    {
-        line = *begin_++;
-        return *this;
-    }
-
-private:
-    InputIterator begin_;
-    InputIterator end_;
-};
-
-// WARNING: Этот "грязный хак" исключительно для примера. Не повторяйте в домашних условиях!
-// std::getline использовать хочется, а наследовать от std::istream - нет.
-namespace std
-{
-    template<typename InputIterator>
-    bool getline(RangeStream<InputIterator>& in, std::string& line)
-    {
-        const bool isEof = in.eof();
-
-        if (!isEof) {
-            in >> line;
-        }
-
-        return !isEof;
-    }
-}
-
 namespace
 {
-    template<typename OStream, typename IStream, typename Transform = Nothing>
-    void transform(OStream&& out, IStream&& in, Transform&& transform = Transform())
+    bool isGzip(const MappedFile& file)
     {
-        for (std::string line; std::getline(in, line);) {
-            out << transform(line) << "\n";
-        }
+        const std::string_view data = file.data();
+        return (data.size() >= 2) && (data[0] == '\x1f') && (data[1] == '\x8b');
     }
 }
 
@@ -89,32 +31,57 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    const std::regex re(R"(https?:\/\/?([\w\.-]+)(\/[\w\.\,\/\+]*)*\/?)");
+    std::set<std::string, std::less<>> domains;
 
-    std::set<std::string> domains;
+    // NOTE: URL-ы ищем конечным автоматом (см. UrlScanner.h), он находит те же совпадения, что и std::regex.
+    // Вектор совпадений заполняется на месте и переиспользуется, поэтому память не выделяется на каждую строку.
+    using Urls = std::vector<std::string_view>;
 
-    std::ifstream file(argv[2], std::ios_base::in | std::ios_base::binary);
+    auto collect = [](std::string_view line, Urls& urls) {
+        urls.clear();
 
-    filtering_streambuf<input> streambuf;
-    streambuf.push(gzip_decompressor());
-    streambuf.push(file);
+        forEachUrl(line, [&urls](std::string_view url) {
+            urls.push_back(url);
+        });
+    };
 
-    std::istream in(&streambuf);
+    try {
+        const MappedFile mapped(argv[2]);
 
-    // NOTE: Применяем функцию преобразования текстовых потоков ("transform()") для парсинга потока.
-    transform(std::ofstream("/dev/null"), in, [&re, &domains](const std::string& line) {
-        for (auto it = std::sregex_iterator(line.begin(), line.end(), re); it != std::sregex_iterator(); ++it) {
-            const std::smatch match = *it;
-            domains.insert(match[0]);
-        }
+        if (isGzip(mapped)) {
+            // NOTE: Распаковываем архив прямо из отображения: канал (<(...)) второй раз уже не прочитать.
+            filtering_streambuf<input> streambuf;
+            streambuf.push(gzip_decompressor());
+            streambuf.push(array_source(mapped.data().data(), mapped.data().size()));
+
+            std::istream in(&streambuf);
 
-        return "";
-    });
+            // NOTE: Применяем конвейерный вариант функции "transform()" для парсинга потока.
+            // Распаковка, поиск URL-лов и наполнение множества идут одновременно в разных потоках.
+            transformPipelinedInto<Urls>(InsertStream(domains), in, collect);
+        } else {
+            // NOTE: Несжатый лог разбираем прямо из отображения файла в память.
+            Urls urls;
 
-    file.close();
+            transform(InsertStream(domains), mapped, [&collect, &urls](std::string_view line) -> const Urls& {
+                collect(line, urls);
+                return urls;
+            });
+        }
 
-    // NOTE: И снова применяем функцию "transform()" вывода результатов из коллекции в файл.
-    transform(std::ofstream(argv[4]), RangeStream(domains.cbegin(), domains.cend()));
+        // NOTE: И снова применяем функцию "transform()" вывода результатов из коллекции в файл.
+        // Вывод идёт крупными порциями через OutputSink, минуя форматирование iostream.
+        OutputSink out(argv[4]);
+        transform(out, RangeStream(domains.cbegin(), domains.cend()));
+
+        // NOTE: Закрываем поток явно: деструктор ошибок не сообщает, а последняя порция данных записывается
+        // только здесь - при нехватке места на диске программа иначе завершилась бы успешно с обрезанным файлом.
+        out.close();
+    } catch (const std::exception& exception) {
+        // NOTE: Ошибки ввода-вывода (например, входной файл не найден). Выводим информацию о них и завершаем программу.
+        std::cerr << "Error occurred: " << exception.what() << "\n";
+        return 1;
+    }
 
     return 0;
 }
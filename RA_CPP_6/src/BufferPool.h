@@ -0,0 +1,131 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @class BufferPool
+ * @brief Пул блоков памяти одинакового размера.
+ *
+ * Блоки, возвращённые в пул, переиспользуются, поэтому при обработке сообщений память не выделяется.
+ * Пул хранит не более указанного числа свободных блоков, лишние освобождаются.
+ * @note Пул потокобезопасен. Он должен жить дольше всех выданных из него буферов.
+ */
+class BufferPool final
+{
+public:
+    /**
+     * @class Buffer
+     * @brief Блок памяти из пула. При уничтожении возвращается в пул.
+     */
+    class Buffer final
+    {
+    public:
+        Buffer() = default;
+
+        Buffer(Buffer&& other) noexcept = default;
+
+        Buffer& operator=(Buffer&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                pool_ = std::exchange(other.pool_, nullptr);
+                data_ = std::move(other.data_);
+            }
+
+            return *this;
+        }
+
+        ~Buffer()
+        {
+            reset();
+        }
+
+        char* data() const noexcept
+        {
+            return data_.get();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(data_);
+        }
+
+        /**
+         * @brief Возвращает блок в пул.
+         */
+        void reset() noexcept
+        {
+            if (data_) {
+                pool_->release(std::move(data_));
+            }
+        }
+
+    private:
+        friend class BufferPool;
+
+        Buffer(BufferPool* pool, std::unique_ptr<char[]> data) noexcept
+            : pool_(pool)
+            , data_(std::move(data))
+        {}
+
+    private:
+        BufferPool* pool_ = nullptr;
+        std::unique_ptr<char[]> data_;
+    };
+
+public:
+    BufferPool(size_t blockSize, size_t maxCached)
+        : blockSize_(blockSize)
+        , maxCached_(maxCached)
+    {
+        free_.reserve(maxCached_);
+    }
+
+    BufferPool(const BufferPool& other) = delete;
+    BufferPool& operator=(const BufferPool& other) = delete;
+
+    size_t blockSize() const noexcept
+    {
+        return blockSize_;
+    }
+
+    /**
+     * @brief Выдаёт свободный блок (или выделяет новый, если свободных нет).
+     */
+    Buffer acquire()
+    {
+        {
+            const std::lock_guard lock(mutex_);
+
+            if (!free_.empty()) {
+                Buffer buffer(this, std::move(free_.back()));
+                free_.pop_back();
+                return buffer;
+            }
+        }
+
+        // NOTE: Память блока не обнуляем (в отличие от std::make_unique): ненужные страницы так и не будут затронуты.
+        return Buffer(this, std::unique_ptr<char[]>(new char[blockSize_]));
+    }
+
+private:
+    void release(std::unique_ptr<char[]> data) noexcept
+    {
+        const std::lock_guard lock(mutex_);
+
+        if (free_.size() < maxCached_) {
+            // NOTE: Место под указатели зарезервировано в конструкторе, поэтому push_back не бросает исключений.
+            free_.push_back(std::move(data));
+        }
+    }
+
+private:
+    const size_t blockSize_;
+    const size_t maxCached_;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<char[]>> free_;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+
+/**
+ * @struct ServerStats
+ * @brief Итоги работы сервера.
+ */
+struct ServerStats final
+{
+    uint64_t connections = 0; // NOTE: Сколько соединений было принято.
+    uint64_t bytes = 0;       // NOTE: Сколько байт отправлено клиентам обратно.
+    uint64_t drained = 0;     // NOTE: Сколько соединений закрыто при остановке после отправки всех полученных данных.
+    uint64_t aborted = 0;     // NOTE: Сколько соединений закрыто принудительно по истечении времени на остановку.
+    double seconds = 0;       // NOTE: Время работы сервера.
+};
+
+inline std::ostream& operator<<(std::ostream& out, const ServerStats& stats)
+{
+    return out << "connections: " << stats.connections
+               << ", bytes echoed: " << stats.bytes
+               << ", drained: " << stats.drained
+               << ", aborted: " << stats.aborted
+               << ", uptime: " << stats.seconds << " s.";
+}
+
+class Connection;
+
+/**
+ * @class ConnectionOwner
+ * @brief Владелец соединений (сервер): получает команду остановки и уведомления о закрытии соединений.
+ */
+class ConnectionOwner
+{
+public:
+    virtual ~ConnectionOwner() = default;
+
+    virtual void requestStop() = 0;
+    virtual void onClosed(const Connection& connection) = 0;
+};
+
+/**
+ * @class Connection
+ * @brief Общая часть соединения с клиентом для всех способов обслуживания.
+ *
+ * Все операции с сокетом выполняются в strand-е соединения. Методы drain() и abort() можно вызывать из любого потока:
+ * они лишь ставят задачу в этот strand.
+ */
+class Connection : public std::enable_shared_from_this<Connection>
+{
+public:
+    Connection(boost::asio::ip::tcp::socket socket, ConnectionOwner& owner)
+        : socket_(std::move(socket))
+        , owner_(owner)
+    {}
+
+    Connection(const Connection& other) = delete;
+    Connection& operator=(const Connection& other) = delete;
+
+    virtual ~Connection() = default;
+
+    virtual void start() = 0;
+
+    /**
+     * @brief Просит соединение завершиться: отправить ответы на уже полученные данные и закрыться.
+     */
+    void drain()
+    {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+            self->draining_ = true;
+
+            // NOTE: Прерываем лишь ожидание новых данных. Начатая отправка завершится как обычно.
+            if (self->waiting_) {
+                boost::system::error_code error;
+                self->socket_.cancel(error);
+            }
+        });
+    }
+
+    /**
+     * @brief Закрывает соединение немедленно, не дожидаясь отправки данных.
+     */
+    void abort()
+    {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()] {
+            boost::system::error_code error;
+            self->aborted_ = true;
+            self->socket_.close(error);
+        });
+    }
+
+    uint64_t bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+    bool aborted() const noexcept
+    {
+        return aborted_;
+    }
+
+protected:
+    /**
+     * @brief Закрывает соединение (сначала сообщив клиенту, что данных больше не будет) и уведомляет владельца.
+     */
+    void close()
+    {
+        if (closed_) {
+            return;
+        }
+
+        closed_ = true;
+
+        boost::system::error_code error;
+        socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_send, error);
+        socket_.close(error);
+
+        owner_.onClosed(*this);
+    }
+
+protected:
+    boost::asio::ip::tcp::socket socket_;
+    ConnectionOwner& owner_;
+
+    uint64_t bytes_ = 0;
+    bool waiting_ = false;  // NOTE: Соединение ждёт новых данных от клиента.
+    bool draining_ = false; // NOTE: Сервер останавливается: новых данных не ждём, дочитываем лишь уже пришедшие.
+    bool aborted_ = false;
+    bool closed_ = false;
+};
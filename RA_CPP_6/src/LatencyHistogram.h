@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @class LatencyHistogram
+ * @brief Гистограмма задержек с логарифмически-линейными корзинами (как в HdrHistogram).
+ *
+ * Значения меньше 2^SUB_BUCKET_BITS хранятся точно. Остальные диапазоны [2^k, 2^(k+1)) делятся
+ * на 2^(SUB_BUCKET_BITS - 1) равных корзин, поэтому относительная погрешность не превышает 1/64
+ * при любом масштабе значений, а размер гистограммы фиксирован (несколько тысяч счётчиков).
+ * @note Гистограмма не потокобезопасна: каждый поток ведёт свою, а в конце они объединяются (merge()).
+ */
+class LatencyHistogram final
+{
+public:
+    LatencyHistogram()
+        : counts_(bucketIndex(std::numeric_limits<uint64_t>::max()) + 1, 0)
+    {}
+
+    void record(uint64_t value)
+    {
+        ++counts_[bucketIndex(value)];
+        ++total_;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+
+        total_ += other.total_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t count() const noexcept
+    {
+        return total_;
+    }
+
+    uint64_t min() const noexcept
+    {
+        return (total_ > 0) ? min_ : 0;
+    }
+
+    uint64_t max() const noexcept
+    {
+        return max_;
+    }
+
+    double mean() const noexcept
+    {
+        return (total_ > 0) ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0;
+    }
+
+    /**
+     * @brief Значение, которого не превышает указанный процент записанных значений (с точностью до корзины).
+     * @param percent процентиль, например, 99.9
+     */
+    uint64_t percentile(double percent) const
+    {
+        if (total_ == 0) {
+            return 0;
+        }
+
+        const double rank = std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(total_);
+        const uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(rank + 0.5), 1);
+
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+
+            if (seen >= target) {
+                // NOTE: Верхняя граница корзины, но не больше максимального записанного значения.
+                return std::min(bucketUpperBound(i), max_);
+            }
+        }
+
+        return max_;
+    }
+
+private:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+
+    static size_t bucketIndex(uint64_t value) noexcept
+    {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+
+        // NOTE: Сдвиг, после которого у значения остаётся SUB_BUCKET_BITS значащих бит.
+        unsigned shift = 1;
+
+        while ((value >> shift) >= SUB_BUCKETS) {
+            ++shift;
+        }
+
+        return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + ((value >> shift) - HALF_SUB_BUCKETS));
+    }
+
+    static uint64_t bucketUpperBound(size_t index) noexcept
+    {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+
+        const uint64_t shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+        const uint64_t top = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+
+        return ((top + 1) << shift) - 1;
+    }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ = 0;
+};
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// NOTE: Минимальная обёртка над системными вызовами io_uring (без liburing): кольца отправки и завершения,
+// и кольцо буферов для чтения. Требуется Linux 6.0+ (многократные accept/recv и кольца буферов).
+
+/**
+ * @class BufferRing
+ * @brief Кольцо буферов одинакового размера, из которых ядро само выбирает буфер для очередного чтения.
+ *
+ * После обработки данных буфер нужно вернуть в кольцо (recycle()), иначе чтения завершатся с ошибкой ENOBUFS.
+ * @note Число буферов должно быть степенью двойки.
+ */
+class BufferRing final
+{
+public:
+    BufferRing(uint16_t count, uint32_t size)
+        : count_(count)
+        , size_(size)
+    {
+        ringSize_ = sizeof(io_uring_buf) * count_;
+        ring_ = static_cast<io_uring_buf*>(map(ringSize_));
+
+        try {
+            buffers_ = static_cast<char*>(map(static_cast<size_t>(count_) * size_));
+        } catch (...) {
+            ::munmap(ring_, ringSize_);
+            throw;
+        }
+
+        for (uint16_t id = 0; id < count_; ++id) {
+            add(id);
+        }
+
+        publish();
+    }
+
+    BufferRing(const BufferRing& other) = delete;
+    BufferRing& operator=(const BufferRing& other) = delete;
+
+    ~BufferRing()
+    {
+        ::munmap(buffers_, static_cast<size_t>(count_) * size_);
+        ::munmap(ring_, ringSize_);
+    }
+
+    char* data(uint16_t id) const noexcept
+    {
+        return buffers_ + static_cast<size_t>(id) * size_;
+    }
+
+    /**
+     * @brief Возвращает буфер в кольцо: ядро снова может выбрать его для чтения.
+     */
+    void recycle(uint16_t id) noexcept
+    {
+        add(id);
+        publish();
+    }
+
+private:
+    friend class Uring;
+
+    static void* map(size_t size)
+    {
+        void* const memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (memory == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+
+        return memory;
+    }
+
+    void add(uint16_t id) noexcept
+    {
+        io_uring_buf& buffer = ring_[tail_ & (count_ - 1)];
+        buffer.addr = reinterpret_cast<uint64_t>(data(id));
+        buffer.len = size_;
+        buffer.bid = id;
+        ++tail_;
+    }
+
+    // NOTE: Хвост кольца читает ядро: новые буферы становятся видны ему лишь после записи хвоста.
+    // Хвост хранится на месте поля resv первого элемента (как в struct io_uring_buf_ring). Саму struct io_uring_buf_ring
+    // не используем: в C++ её гибкий массив bufs (из-за пустой структуры в макросе __DECLARE_FLEX_ARRAY) сдвинут на 8 байт.
+    void publish() noexcept
+    {
+        __atomic_store_n(&ring_[0].resv, tail_, __ATOMIC_RELEASE);
+    }
+
+private:
+    const uint16_t count_;
+    const uint32_t size_;
+
+    size_t ringSize_ = 0;
+    io_uring_buf* ring_ = nullptr;
+    char* buffers_ = nullptr;
+    uint16_t tail_ = 0;
+};
+
+/**
+ * @class Uring
+ * @brief Кольцо io_uring: очередь запросов (SQE) и очередь завершений (CQE).
+ *
+ * Запросы накапливаются (prepare()) и передаются ядру одним системным вызовом вместе с ожиданием завершений (submit()).
+ * @note Кольцо должно использоваться одним потоком - тем, который его создал.
+ */
+class Uring final
+{
+public:
+    explicit Uring(unsigned entries)
+    {
+        io_uring_params params{};
+
+        // NOTE: Кольцо обслуживает один поток, поэтому ядро может откладывать работу по завершению запросов
+        // до следующего системного вызова, а не прерывать поток (Linux 6.1+). На старых ядрах - без этих флагов.
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        params.cq_entries = entries * 4;
+
+        fd_ = setup(entries, params);
+
+        if (fd_ < 0 && errno == EINVAL) {
+            params = {};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = entries * 4;
+
+            fd_ = setup(entries, params);
+        }
+
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+        }
+
+        try {
+            map(params);
+        } catch (...) {
+            unmap();
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    Uring(const Uring& other) = delete;
+    Uring& operator=(const Uring& other) = delete;
+
+    ~Uring()
+    {
+        unmap();
+        ::close(fd_);
+    }
+
+    /**
+     * @brief Регистрирует кольцо буферов под указанным номером группы.
+     * @note Кольцо буферов должно жить дольше кольца io_uring.
+     */
+    void registerBuffers(BufferRing& buffers, uint16_t group)
+    {
+        io_uring_buf_reg registration{};
+        registration.ring_addr = reinterpret_cast<uint64_t>(buffers.ring_);
+        registration.ring_entries = buffers.count_;
+        registration.bgid = group;
+
+        if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_register");
+        }
+    }
+
+    /**
+     * @brief Выдаёт чистый запрос для заполнения. Если очередь полна, накопленные запросы сначала передаются ядру.
+     */
+    io_uring_sqe& prepare()
+    {
+        while (sqTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+            // NOTE: Ядро не принимает запросы, пока переполнена очередь завершений. Обработать завершения здесь
+            // нельзя, поэтому переносим их в резерв (их получит complete()) и освобождаем место в очереди.
+            if (!submit(0)) {
+                drain();
+            }
+        }
+
+        io_uring_sqe& sqe = sqes_[sqTail_ & sqMask_];
+        std::memset(&sqe, 0, sizeof(sqe));
+        ++sqTail_;
+
+        return sqe;
+    }
+
+    /**
+     * @brief Передаёт ядру накопленные запросы и ждёт, пока не будет готово хотя бы указанное число завершений.
+     * @return false, если ядро не приняло запросы из-за переполненной очереди завершений: сначала нужно
+     *         обработать завершения (complete())
+     */
+    bool submit(unsigned waitFor)
+    {
+        __atomic_store_n(sqKernelTail_, sqTail_, __ATOMIC_RELEASE);
+
+        // NOTE: Завершения в резерве уже готовы - ждать новых не нужно.
+        if (!backlog_.empty()) {
+            waitFor = 0;
+        }
+
+        while (true) {
+            const unsigned pending = sqTail_ - submitted_;
+            const long result = ::syscall(__NR_io_uring_enter, fd_, pending, waitFor, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+            if (result >= 0) {
+                submitted_ += static_cast<unsigned>(result);
+                return true;
+            }
+
+            if (errno == EBUSY || errno == EAGAIN) {
+                return false;
+            }
+
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+            }
+        }
+    }
+
+    /**
+     * @brief Вызывает обработчик для каждого готового завершения и освобождает их.
+     */
+    template <typename Handler>
+    void complete(Handler&& handler)
+    {
+        // NOTE: Забираем все готовые завершения сразу: место в очереди освобождается до вызова обработчиков, которые
+        // могут подавать новые запросы. Завершения, перенесённые в резерв обработчиком, получит следующий вызов.
+        drain();
+        backlog_.swap(completing_);
+
+        for (const io_uring_cqe& cqe : completing_) {
+            handler(cqe);
+        }
+
+        completing_.clear();
+    }
+
+private:
+    /**
+     * @brief Переносит готовые завершения в резерв (по порядку) и освобождает их место в очереди.
+     */
+    void drain()
+    {
+        const unsigned head = *cqHead_;
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+        for (unsigned i = head; i != tail; ++i) {
+            backlog_.push_back(cqes_[i & cqMask_]);
+        }
+
+        __atomic_store_n(cqHead_, tail, __ATOMIC_RELEASE);
+    }
+
+    static int setup(unsigned entries, io_uring_params& params)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    }
+
+    void map(const io_uring_params& params)
+    {
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        // NOTE: На ядрах 5.4+ обе очереди отображаются одним вызовом mmap.
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = mapRegion(sqRingSize_, IORING_OFF_SQ_RING);
+        cqRing_ = (params.features & IORING_FEAT_SINGLE_MMAP) ? sqRing_ : mapRegion(cqRingSize_, IORING_OFF_CQ_RING);
+
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mapRegion(sqesSize_, IORING_OFF_SQES));
+
+        auto* const sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqKernelTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqEntries_ = params.sq_entries;
+
+        // NOTE: Запросы передаются ядру строго по порядку, поэтому массив индексов заполняется один раз.
+        auto* const array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        for (unsigned i = 0; i < sqEntries_; ++i) {
+            array[i] = i;
+        }
+
+        sqTail_ = submitted_ = *sqKernelTail_;
+
+        auto* const cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    void* mapRegion(size_t size, off_t offset)
+    {
+        void* const memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+
+        if (memory == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+
+        return memory;
+    }
+
+    void unmap() noexcept
+    {
+        if (sqes_) {
+            ::munmap(sqes_, sqesSize_);
+        }
+
+        if (cqRing_ && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+
+        if (sqRing_) {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+    }
+
+private:
+    int fd_ = -1;
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqKernelTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned sqTail_ = 0;    // NOTE: Хвост очереди запросов, ещё не переданный ядру.
+    unsigned submitted_ = 0; // NOTE: Сколько запросов ядро уже приняло.
+
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::vector<io_uring_cqe> backlog_;    // NOTE: Завершения, забранные из очереди, но ещё не обработанные.
+    std::vector<io_uring_cqe> completing_; // NOTE: Завершения, обрабатываемые в complete().
+};
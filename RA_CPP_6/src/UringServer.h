@@ -0,0 +1,834 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <linux/time_types.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "Connection.h"
+#include "Uring.h"
+
+/**
+ * @class FileDescriptor
+ * @brief Владеющая обёртка над файловым дескриптором.
+ */
+class FileDescriptor final
+{
+public:
+    FileDescriptor() = default;
+
+    /**
+     * @throw std::system_error, если дескриптор некорректен (результат неудачного системного вызова)
+     */
+    FileDescriptor(int fd, const char* operation)
+        : fd_(fd)
+    {
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), operation);
+        }
+    }
+
+    FileDescriptor(FileDescriptor&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+    {}
+
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept
+    {
+        std::swap(fd_, other.fd_);
+        return *this;
+    }
+
+    ~FileDescriptor()
+    {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    int get() const noexcept
+    {
+        return fd_;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+/**
+ * @class UringServer
+ * @brief Эхо-сервер (протокол строк) на io_uring: вариант движка для очень большого числа соединений.
+ *
+ * Каждый поток обслуживает собственное кольцо io_uring и собственные соединения:
+ * - соединения принимаются многократным запросом accept (по одному в кольце каждого потока на общем слушающем сокете);
+ * - данные читаются одним многократным запросом recv на соединение в буферы из зарегистрированного кольца буферов,
+ *   поэтому простаивающее соединение не держит буфер чтения;
+ * - все полные строки, прочитанные из соединения, отправляются одной записью, а все запросы, подготовленные
+ *   при обработке очередной пачки завершений, передаются ядру одним системным вызовом.
+ *
+ * Остановка (команда SERVER_STOP или сигналы SIGINT/SIGTERM) - как у движков на asio: соединения отправляют
+ * ответы на уже полученные данные и закрываются, а не успевшие к сроку закрываются принудительно.
+ */
+class UringServer final
+{
+public:
+    UringServer(const boost::asio::ip::tcp::endpoint& endpoint, size_t threads, int backlog, size_t bufferSize,
+                std::chrono::milliseconds shutdownTimeout)
+        : bufferSize_(static_cast<uint32_t>(std::min<size_t>(bufferSize, MAX_BUFFER_SIZE)))
+        , shutdownTimeout_(shutdownTimeout)
+        , listener_(listen(endpoint, backlog))
+    {
+        for (size_t i = 0; i < threads; ++i) {
+            wakers_.emplace_back(::eventfd(0, EFD_CLOEXEC), "eventfd");
+        }
+    }
+
+    UringServer(const UringServer& other) = delete;
+    UringServer& operator=(const UringServer& other) = delete;
+
+    /**
+     * @brief Проверяет, что ядро поддерживает всё, что нужно движку (многократный recv в кольцо буферов).
+     * @throw std::exception с описанием причины, если не поддерживает (или io_uring запрещён)
+     */
+    static void probe()
+    {
+        int pair[2];
+
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) {
+            throw std::system_error(errno, std::generic_category(), "socketpair");
+        }
+
+        const FileDescriptor reader(pair[0], "socketpair");
+        const FileDescriptor writer(pair[1], "socketpair");
+
+        // NOTE: Кольцо уничтожается раньше буферов, на которые ссылается его незавершённый запрос.
+        BufferRing buffers(2, 64);
+        Uring ring(8);
+        ring.registerBuffers(buffers, BUFFER_GROUP);
+
+        prepareReceive(ring.prepare(), reader.get());
+
+        if (::write(writer.get(), "x", 1) != 1) {
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+
+        bool supported = false;
+
+        ring.submit(1);
+        ring.complete([&supported](const io_uring_cqe& cqe) {
+            supported = (cqe.res == 1) && (cqe.flags & IORING_CQE_F_MORE);
+        });
+
+        if (!supported) {
+            throw std::runtime_error("multishot receive into a buffer ring is not supported by the kernel");
+        }
+    }
+
+    /**
+     * @brief Обслуживает клиентов до остановки.
+     * @return итоги работы (кроме времени работы)
+     */
+    ServerStats run()
+    {
+        // NOTE: Сигналы остановки принимаем не обработчиком, а чтением из signalfd в кольце первого потока.
+        // Маска сигналов наследуется потоками, поэтому блокируем их до запуска потоков.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+
+        sigset_t previous;
+        pthread_sigmask(SIG_BLOCK, &signals, &previous);
+
+        std::vector<ServerStats> stats(wakers_.size());
+        std::exception_ptr error;
+        std::mutex mutex;
+
+        try {
+            const FileDescriptor signalFd(::signalfd(-1, &signals, SFD_CLOEXEC), "signalfd");
+
+            std::vector<std::thread> threads;
+
+            for (size_t i = 0; i < wakers_.size(); ++i) {
+                threads.emplace_back([&, i] {
+                    try {
+                        // NOTE: Кольцо создаётся и используется только в своём потоке.
+                        Loop loop(*this, i, (i == 0) ? signalFd.get() : -1);
+                        stats[i] = loop.run();
+                    } catch (...) {
+                        {
+                            const std::lock_guard lock(mutex);
+                            error = std::current_exception();
+                        }
+
+                        requestStop();
+                    }
+                });
+            }
+
+            std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        ServerStats total;
+
+        for (const ServerStats& loopStats : stats) {
+            total.connections += loopStats.connections;
+            total.bytes += loopStats.bytes;
+            total.drained += loopStats.drained;
+            total.aborted += loopStats.aborted;
+        }
+
+        return total;
+    }
+
+    /**
+     * @brief Начинает остановку сервера.
+     * @note Можно вызывать из любого потока, в том числе повторно.
+     */
+    void requestStop()
+    {
+        if (stopping_.exchange(true)) {
+            return;
+        }
+
+        for (const FileDescriptor& waker : wakers_) {
+            const uint64_t value = 1;
+            [[maybe_unused]] const ssize_t written = ::write(waker.get(), &value, sizeof(value));
+        }
+    }
+
+private:
+    /**
+     * @class Loop
+     * @brief Цикл обработки завершений одного потока: его кольцо, слушающий сокет и соединения.
+     */
+    class Loop final
+    {
+    public:
+        Loop(UringServer& server, size_t index, int signalFd)
+            : server_(server)
+            , listenFd_(server.listener_.get())
+            , wakeFd_(server.wakers_[index].get())
+            , signalFd_(signalFd)
+            , buffers_(bufferCount(server.bufferSize_), server.bufferSize_)
+            , scratch_(server.bufferSize_)
+        {
+            ring_.registerBuffers(buffers_, BUFFER_GROUP);
+        }
+
+        ServerStats run()
+        {
+            accept();
+            waitFor(Operation::Wake, wakeFd_, &wakeValue_, sizeof(wakeValue_));
+
+            if (signalFd_ >= 0) {
+                waitFor(Operation::Signal, signalFd_, &signal_, sizeof(signal_));
+            }
+
+            while (!stopping_ || active_ > 0) {
+                ring_.submit(1);
+                ring_.complete([this](const io_uring_cqe& cqe) {
+                    handle(cqe);
+                });
+            }
+
+            // NOTE: Отменяем оставшиеся запросы (ожидание сигнала, срок остановки) и дожидаемся их завершения,
+            // чтобы ядро не обращалось к памяти цикла после выхода из него.
+            io_uring_sqe& sqe = prepare(Operation::Cancel, 0);
+            sqe.opcode = IORING_OP_ASYNC_CANCEL;
+            sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+
+            while (pending_ > 0) {
+                ring_.submit(1);
+                ring_.complete([this](const io_uring_cqe& cqe) {
+                    handle(cqe);
+                });
+            }
+
+            return stats_;
+        }
+
+    private:
+        enum class Operation : uint8_t
+        {
+            Accept,
+            Receive,
+            Send,
+            Wake,
+            Signal,
+            Deadline,
+            Cancel
+        };
+
+        /**
+         * @struct Client
+         * @brief Состояние соединения с клиентом.
+         */
+        struct Client final
+        {
+            int fd = -1;
+            size_t index = 0;      // NOTE: Номер в таблице соединений (входит в user_data запросов).
+            unsigned requests = 0; // NOTE: Сколько запросов соединения ещё не завершено.
+            uint64_t bytes = 0;
+
+            std::string pending;  // NOTE: Начало строки, конец которой ещё не пришёл.
+            std::string output;   // NOTE: Полные строки, ожидающие отправки.
+            std::string sending;  // NOTE: Строки, отправляемые сейчас (ядро читает их до завершения запроса).
+            size_t sent = 0;
+
+            bool receiving = false; // NOTE: Многократный recv активен.
+            bool paused = false;    // NOTE: Чтение приостановлено: клиент не успевает забирать ответы.
+            bool draining = false;  // NOTE: Сервер останавливается: дочитываем лишь уже пришедшие данные.
+            bool closing = false;   // NOTE: Новых данных не будет: отправляем оставшиеся ответы и закрываем.
+            bool shut = false;      // NOTE: Соединение закрыто, ждём завершения его запросов.
+            bool aborted = false;
+        };
+
+        static uint64_t userData(Operation operation, size_t index) noexcept
+        {
+            return (static_cast<uint64_t>(index) << 8) | static_cast<uint64_t>(operation);
+        }
+
+        static uint16_t bufferCount(uint32_t bufferSize) noexcept
+        {
+            uint16_t count = MIN_BUFFERS;
+
+            while (count < MAX_BUFFERS && static_cast<size_t>(count) * 2 * bufferSize <= RECEIVE_MEMORY) {
+                count *= 2;
+            }
+
+            return count;
+        }
+
+        io_uring_sqe& prepare(Operation operation, size_t index)
+        {
+            io_uring_sqe& sqe = ring_.prepare();
+            sqe.user_data = userData(operation, index);
+            ++pending_;
+
+            return sqe;
+        }
+
+        void handle(const io_uring_cqe& cqe)
+        {
+            // NOTE: Многократный запрос завершается последним своим завершением (без флага IORING_CQE_F_MORE).
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                --pending_;
+            }
+
+            const auto operation = static_cast<Operation>(cqe.user_data & 0xFF);
+            const auto index = static_cast<size_t>(cqe.user_data >> 8);
+
+            switch (operation) {
+            case Operation::Accept:
+                onAccept(cqe);
+                break;
+            case Operation::Receive:
+                onReceive(*clients_[index], cqe);
+                release(index);
+                break;
+            case Operation::Send:
+                onSent(*clients_[index], cqe);
+                release(index);
+                break;
+            case Operation::Wake:
+                beginStop();
+                break;
+            case Operation::Signal:
+                if (cqe.res > 0) {
+                    server_.requestStop();
+                }
+                break;
+            case Operation::Deadline:
+                deadlineArmed_ = false;
+
+                // NOTE: Соединения, не завершившиеся к сроку, закрываем принудительно.
+                if (cqe.res == -ETIME) {
+                    for (const auto& client : clients_) {
+                        if (client && !client->shut) {
+                            abort(*client);
+                            release(client->index);
+                        }
+                    }
+                }
+                break;
+            case Operation::Cancel:
+                break;
+            }
+        }
+
+        void waitFor(Operation operation, int fd, void* data, unsigned size)
+        {
+            io_uring_sqe& sqe = prepare(operation, 0);
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(data);
+            sqe.len = size;
+        }
+
+        void accept()
+        {
+            io_uring_sqe& sqe = prepare(Operation::Accept, 0);
+            sqe.opcode = IORING_OP_ACCEPT;
+            sqe.fd = listenFd_;
+            sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe.accept_flags = SOCK_CLOEXEC;
+
+            accepting_ = true;
+        }
+
+        void onAccept(const io_uring_cqe& cqe)
+        {
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                accepting_ = false;
+            }
+
+            if (cqe.res >= 0) {
+                if (stopping_) {
+                    ::close(cqe.res);
+                } else {
+                    open(cqe.res);
+                }
+            } else if (cqe.res != -ECANCELED && !stopping_) {
+                // NOTE: Ошибка приёма (например, исчерпан лимит дескрипторов) не должна останавливать сервер.
+                std::cerr << "Accept failed: " << std::strerror(-cqe.res) << "\n";
+            }
+
+            if (!accepting_ && !stopping_) {
+                accept();
+            }
+        }
+
+        void open(int fd)
+        {
+            size_t index = clients_.size();
+
+            if (!free_.empty()) {
+                index = free_.back();
+                free_.pop_back();
+            } else {
+                clients_.emplace_back();
+            }
+
+            clients_[index] = std::make_unique<Client>();
+
+            Client& client = *clients_[index];
+            client.fd = fd;
+            client.index = index;
+
+            ++active_;
+            ++stats_.connections;
+
+            receive(client);
+        }
+
+        void receive(Client& client)
+        {
+            prepareReceive(prepare(Operation::Receive, client.index), client.fd);
+
+            ++client.requests;
+            client.receiving = true;
+        }
+
+        void onReceive(Client& client, const io_uring_cqe& cqe)
+        {
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                --client.requests;
+                client.receiving = false;
+            }
+
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                const auto id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+                if (cqe.res > 0 && !client.closing) {
+                    consume(client, std::string_view(buffers_.data(id), static_cast<size_t>(cqe.res)));
+                }
+
+                buffers_.recycle(id);
+            }
+
+            if (cqe.res == 0) {
+                // NOTE: Клиент больше ничего не пришлёт - отвечаем на полученное и закрываем соединение.
+                client.closing = true;
+            } else if (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED) {
+                // NOTE: Ошибка сети - отвечать уже некому.
+                client.output.clear();
+                client.closing = true;
+            }
+
+            if (!client.receiving && !client.closing) {
+                if (client.draining) {
+                    drainRemaining(client);
+                } else if (!client.paused) {
+                    // NOTE: Запрос завершился сам (например, кончились свободные буферы) - подаём его снова.
+                    receive(client);
+                }
+            }
+
+            flush(client);
+        }
+
+        /**
+         * @brief Переносит полные строки в очередь отправки. Строка "SERVER_STOP" - команда остановки сервера.
+         */
+        void consume(Client& client, std::string_view data)
+        {
+            const size_t last = data.rfind('\n');
+
+            if (last == std::string_view::npos) {
+                client.pending.append(data);
+
+                // NOTE: Ограничиваем длину строки, чтобы клиент без '\n' не мог занять всю память сервера.
+                if (client.pending.size() > MAX_LINE) {
+                    client.pending.clear();
+                    client.closing = true;
+                }
+
+                return;
+            }
+
+            size_t begin = 0;
+            bool stop = false;
+
+            while (begin <= last) {
+                const size_t end = data.find('\n', begin);
+
+                // NOTE: Начало первой строки могло прийти ещё при прошлом чтении.
+                if (isStopCommand((begin == 0) ? client.pending : std::string_view(), data.substr(begin, end - begin))) {
+                    stop = true;
+                    break;
+                }
+
+                begin = end + 1;
+            }
+
+            if (stop && begin == 0) {
+                client.pending.clear();
+            }
+
+            client.output.append(client.pending);
+            client.output.append(data.data(), begin);
+
+            if (stop) {
+                server_.requestStop();
+                client.pending.clear();
+                client.closing = true;
+                return;
+            }
+
+            client.pending.assign(data.substr(last + 1));
+        }
+
+        static bool isStopCommand(std::string_view head, std::string_view tail) noexcept
+        {
+            constexpr std::string_view command = "SERVER_STOP";
+
+            return (head.size() + tail.size() == command.size())
+                && (command.substr(0, head.size()) == head)
+                && (command.substr(head.size()) == tail);
+        }
+
+        void flush(Client& client)
+        {
+            if (client.shut) {
+                return;
+            }
+
+            if (client.sending.empty()) {
+                if (client.output.empty()) {
+                    if (client.closing) {
+                        finish(client);
+                    }
+
+                    return;
+                }
+
+                // NOTE: Пока ядро отправляет одну очередь строк, новые строки копятся в другой.
+                std::swap(client.sending, client.output);
+                client.sent = 0;
+                send(client);
+            }
+
+            // NOTE: Клиент не забирает ответы - перестаём читать, пока очереди не разгрузятся.
+            if (client.receiving && !client.paused && client.sending.size() + client.output.size() > HIGH_WATER) {
+                client.paused = true;
+                cancel(userData(Operation::Receive, client.index));
+            }
+        }
+
+        void send(Client& client)
+        {
+            io_uring_sqe& sqe = prepare(Operation::Send, client.index);
+            sqe.opcode = IORING_OP_SEND;
+            sqe.fd = client.fd;
+            sqe.addr = reinterpret_cast<uint64_t>(client.sending.data() + client.sent);
+            sqe.len = static_cast<uint32_t>(client.sending.size() - client.sent);
+            sqe.msg_flags = MSG_NOSIGNAL;
+
+            ++client.requests;
+        }
+
+        void onSent(Client& client, const io_uring_cqe& cqe)
+        {
+            --client.requests;
+
+            if (cqe.res < 0 || client.shut) {
+                client.sending.clear();
+                client.output.clear();
+                client.closing = true;
+                flush(client);
+                return;
+            }
+
+            client.bytes += static_cast<uint64_t>(cqe.res);
+            client.sent += static_cast<size_t>(cqe.res);
+
+            if (client.sent < client.sending.size()) {
+                send(client);
+                return;
+            }
+
+            client.sending.clear();
+
+            // NOTE: Не держим память простаивающего соединения.
+            if (client.output.empty()) {
+                client.sending.shrink_to_fit();
+                client.output.shrink_to_fit();
+            }
+
+            if (client.paused && !client.closing && !client.draining && client.output.size() <= HIGH_WATER / 2) {
+                client.paused = false;
+
+                if (!client.receiving) {
+                    receive(client);
+                }
+            }
+
+            flush(client);
+        }
+
+        void cancel(uint64_t target)
+        {
+            io_uring_sqe& sqe = prepare(Operation::Cancel, 0);
+            sqe.opcode = IORING_OP_ASYNC_CANCEL;
+            sqe.addr = target;
+        }
+
+        // NOTE: Сервер останавливается. Дочитываем уже пришедшие данные (без ожидания) и закрываем соединение.
+        void drainRemaining(Client& client)
+        {
+            while (!client.closing) {
+                const ssize_t size = ::recv(client.fd, scratch_.data(), scratch_.size(), MSG_DONTWAIT);
+
+                if (size <= 0) {
+                    break;
+                }
+
+                consume(client, std::string_view(scratch_.data(), static_cast<size_t>(size)));
+            }
+
+            client.closing = true;
+        }
+
+        // NOTE: Все ответы отправлены - сообщаем клиенту, что данных больше не будет, и закрываем соединение.
+        void finish(Client& client)
+        {
+            client.shut = true;
+            ::shutdown(client.fd, SHUT_WR);
+
+            if (client.receiving) {
+                cancel(userData(Operation::Receive, client.index));
+            }
+        }
+
+        void abort(Client& client)
+        {
+            client.aborted = true;
+            client.shut = true;
+            client.output.clear();
+            ::shutdown(client.fd, SHUT_RDWR);
+
+            io_uring_sqe& sqe = prepare(Operation::Cancel, 0);
+            sqe.opcode = IORING_OP_ASYNC_CANCEL;
+            sqe.fd = client.fd;
+            sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        }
+
+        // NOTE: Соединение освобождается, лишь когда завершены все его запросы: ядро ещё может обращаться к его буферам.
+        void release(size_t index)
+        {
+            Client& client = *clients_[index];
+
+            if (!client.shut || client.requests > 0) {
+                return;
+            }
+
+            ::close(client.fd);
+
+            stats_.bytes += client.bytes;
+
+            if (client.aborted) {
+                ++stats_.aborted;
+            } else if (stopping_) {
+                ++stats_.drained;
+            }
+
+            clients_[index].reset();
+            free_.push_back(index);
+            --active_;
+
+            // NOTE: Все соединения завершились - ждать срока остановки больше незачем.
+            if (stopping_ && active_ == 0 && deadlineArmed_) {
+                cancel(userData(Operation::Deadline, 0));
+                deadlineArmed_ = false;
+            }
+        }
+
+        void beginStop()
+        {
+            if (stopping_) {
+                return;
+            }
+
+            stopping_ = true;
+
+            if (accepting_) {
+                cancel(userData(Operation::Accept, 0));
+            }
+
+            for (const auto& client : clients_) {
+                if (client && !client->closing) {
+                    client->draining = true;
+
+                    if (client->receiving) {
+                        // NOTE: Данные дочитаем после завершения отменённого запроса (см. onReceive()).
+                        cancel(userData(Operation::Receive, client->index));
+                    } else {
+                        drainRemaining(*client);
+                        flush(*client);
+                        release(client->index);
+                    }
+                }
+            }
+
+            if (active_ > 0) {
+                const auto timeout = server_.shutdownTimeout_;
+                deadline_.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(timeout).count();
+                deadline_.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout % std::chrono::seconds(1)).count();
+
+                io_uring_sqe& sqe = prepare(Operation::Deadline, 0);
+                sqe.opcode = IORING_OP_TIMEOUT;
+                sqe.addr = reinterpret_cast<uint64_t>(&deadline_);
+                sqe.len = 1;
+
+                deadlineArmed_ = true;
+            }
+        }
+
+    private:
+        UringServer& server_;
+        const int listenFd_;
+        const int wakeFd_;
+        const int signalFd_;
+
+        BufferRing buffers_;
+        std::vector<char> scratch_;
+        std::vector<std::unique_ptr<Client>> clients_;
+        std::vector<size_t> free_;
+        size_t active_ = 0;
+
+        uint64_t wakeValue_ = 0;
+        signalfd_siginfo signal_{};
+        __kernel_timespec deadline_{};
+
+        size_t pending_ = 0; // NOTE: Сколько запросов ещё не завершено.
+        bool accepting_ = false;
+        bool stopping_ = false;
+        bool deadlineArmed_ = false;
+        ServerStats stats_;
+
+        // NOTE: Кольцо объявлено последним и уничтожается первым: буферы должны пережить его.
+        Uring ring_{ RING_ENTRIES };
+    };
+
+    /**
+     * @brief Многократный recv: ядро выбирает буфер из кольца для каждой порции данных, пока запрос не отменён.
+     */
+    static void prepareReceive(io_uring_sqe& sqe, int fd)
+    {
+        sqe.opcode = IORING_OP_RECV;
+        sqe.fd = fd;
+        sqe.ioprio = IORING_RECV_MULTISHOT;
+        sqe.flags = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = BUFFER_GROUP;
+    }
+
+    static FileDescriptor listen(const boost::asio::ip::tcp::endpoint& endpoint, int backlog)
+    {
+        FileDescriptor fd(::socket(endpoint.protocol().family(), SOCK_STREAM | SOCK_CLOEXEC, 0), "socket");
+
+        const int enable = 1;
+
+        if (::setsockopt(fd.get(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0) {
+            throw std::system_error(errno, std::generic_category(), "setsockopt");
+        }
+
+        if (::bind(fd.get(), endpoint.data(), static_cast<socklen_t>(endpoint.size())) < 0) {
+            throw std::system_error(errno, std::generic_category(), "bind");
+        }
+
+        if (::listen(fd.get(), backlog) < 0) {
+            throw std::system_error(errno, std::generic_category(), "listen");
+        }
+
+        return fd;
+    }
+
+private:
+    static constexpr uint16_t BUFFER_GROUP = 0;
+    static constexpr unsigned RING_ENTRIES = 4096;
+    static constexpr size_t MAX_LINE = 64 * 1024;
+    static constexpr size_t HIGH_WATER = 4 * 1024 * 1024;    // NOTE: Сколько ответов может ждать отправки у одного соединения.
+    static constexpr size_t RECEIVE_MEMORY = 4 * 1024 * 1024; // NOTE: Память под буферы чтения одного потока.
+    static constexpr size_t MAX_BUFFER_SIZE = 1024 * 1024;
+    static constexpr uint16_t MIN_BUFFERS = 16;
+    static constexpr uint16_t MAX_BUFFERS = 4096;
+
+    const uint32_t bufferSize_;
+    const std::chrono::milliseconds shutdownTimeout_;
+
+    FileDescriptor listener_;
+    std::vector<FileDescriptor> wakers_;
+    std::atomic<bool> stopping_ = false;
+};
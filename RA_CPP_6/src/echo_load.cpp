@@ -0,0 +1,484 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+
+#include "LatencyHistogram.h"
+
+// NOTE: Нагрузочный тест EchoServer: M соединений, по каждому K сообщений с конвейерной отправкой
+// (не дожидаясь ответов на предыдущие). Измеряются задержки (от отправки сообщения до получения эха)
+// и пропускная способность. Результаты выводятся таблицей или (с ключом --json) в формате JSON.
+
+using namespace boost::asio;
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Параметры нагрузки.
+     */
+    struct Options final
+    {
+        std::string host = "127.0.0.1";
+        unsigned short port = 5555;
+        size_t connections = 100;
+        size_t messages = 10000; // NOTE: Сколько сообщений отправляется по каждому соединению.
+        size_t size = 64;        // NOTE: Размер сообщения (строки вместе с '\n' или данных кадра).
+        size_t depth = 16;       // NOTE: Сколько сообщений одного соединения может ожидать ответа одновременно.
+        size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        std::string protocol = "lines";
+        bool stop = false;       // NOTE: По окончании отправить серверу команду остановки.
+        std::optional<std::string> json;
+    };
+
+    /**
+     * @return целое число из диапазона [minimum, maximum], записанное в строке, или std::nullopt
+     */
+    std::optional<size_t> parseNumber(std::string_view text,
+                                      size_t minimum = 1,
+                                      size_t maximum = std::numeric_limits<size_t>::max())
+    {
+        size_t number = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+
+        if (error != std::errc() || end != text.data() + text.size() || number < minimum || number > maximum) {
+            return std::nullopt;
+        }
+
+        return number;
+    }
+
+    /**
+     * @return поле параметров, задаваемое положительным целым числом, или nullptr
+     */
+    size_t* countOption(Options& options, std::string_view key) noexcept
+    {
+        if (key == "--connections") {
+            return &options.connections;
+        } else if (key == "--messages") {
+            return &options.messages;
+        } else if (key == "--size") {
+            return &options.size;
+        } else if (key == "--depth") {
+            return &options.depth;
+        } else if (key == "--threads") {
+            return &options.threads;
+        }
+
+        return nullptr;
+    }
+
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view key = argv[i];
+
+            if (key == "--stop") {
+                options.stop = true;
+                continue;
+            }
+
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            const std::string value = argv[++i];
+
+            if (key == "--host") {
+                options.host = value;
+            } else if (key == "--port") {
+                const std::optional<size_t> port = parseNumber(value, 1, std::numeric_limits<unsigned short>::max());
+
+                if (!port) {
+                    return std::nullopt;
+                }
+
+                options.port = static_cast<unsigned short>(*port);
+            } else if (size_t* const target = countOption(options, key)) {
+                const std::optional<size_t> count = parseNumber(value);
+
+                if (!count) {
+                    return std::nullopt;
+                }
+
+                *target = *count;
+            } else if (key == "--protocol" && (value == "lines" || value == "frames")) {
+                options.protocol = value;
+            } else if (key == "--json") {
+                options.json = value;
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        return options;
+    }
+
+    /**
+     * @brief Сообщение в формате протокола: строка из size - 1 символов и '\n' либо кадр (длина и данные).
+     */
+    std::string makeMessage(const Options& options)
+    {
+        if (options.protocol == "frames") {
+            std::string message(4 + options.size, 'x');
+
+            for (size_t i = 0; i < 4; ++i) {
+                message[i] = static_cast<char>((options.size >> (8 * (3 - i))) & 0xFF);
+            }
+
+            return message;
+        }
+
+        std::string message(options.size, 'x');
+        message.back() = '\n';
+        return message;
+    }
+
+    /**
+     * @struct Worker
+     * @brief Поток нагрузки: собственный io_context и гистограмма задержек обслуживаемых им соединений.
+     *
+     * Каждое соединение обслуживается одним потоком, поэтому ни соединениям, ни гистограмме синхронизация не нужна.
+     */
+    struct Worker final
+    {
+        io_context context;
+        LatencyHistogram histogram;
+        size_t failed = 0;
+    };
+
+    /**
+     * @class Client
+     * @brief Соединение с сервером: отправляет сообщения пачками, не дожидаясь ответов, пока их не больше depth.
+     *
+     * Сервер возвращает сообщения без изменений и в том же порядке, поэтому ответы считаются по числу байт,
+     * а время отправки каждого ожидающего сообщения хранится в кольцевом буфере из depth элементов.
+     */
+    class Client final
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        Client(Worker& worker, const Options& options, const std::string& batch, size_t messageSize)
+            : worker_(worker)
+            , options_(options)
+            , batch_(batch)
+            , messageSize_(messageSize)
+            , socket_(worker.context)
+            , sentAt_(options.depth)
+        {}
+
+        void connect(const ip::tcp::endpoint& endpoint)
+        {
+            socket_.connect(endpoint);
+
+            // NOTE: Без этого алгоритм Нейгла задерживает небольшие сообщения и искажает задержки.
+            socket_.set_option(ip::tcp::no_delay(true));
+        }
+
+        void start()
+        {
+            send();
+            read();
+        }
+
+    private:
+        void send()
+        {
+            if (writing_ || sent_ == options_.messages) {
+                return;
+            }
+
+            const size_t count = std::min(options_.depth - (sent_ - received_), options_.messages - sent_);
+
+            if (count == 0) {
+                return;
+            }
+
+            const Clock::time_point now = Clock::now();
+
+            for (size_t i = 0; i < count; ++i) {
+                sentAt_[(sent_ + i) % options_.depth] = now;
+            }
+
+            sent_ += count;
+            writing_ = true;
+
+            async_write(socket_, buffer(batch_.data(), count * messageSize_), [this](const boost::system::error_code& error, size_t) {
+                writing_ = false;
+
+                if (error) {
+                    fail();
+                    return;
+                }
+
+                send();
+            });
+        }
+
+        void read()
+        {
+            socket_.async_read_some(buffer(buffer_), [this](const boost::system::error_code& error, size_t size) {
+                if (error) {
+                    fail();
+                    return;
+                }
+
+                const Clock::time_point now = Clock::now();
+
+                receivedBytes_ += size;
+
+                for (const size_t complete = receivedBytes_ / messageSize_; received_ < complete; ++received_) {
+                    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt_[received_ % options_.depth]);
+                    worker_.histogram.record(static_cast<uint64_t>(latency.count()));
+                }
+
+                if (received_ == options_.messages) {
+                    boost::system::error_code ignored;
+                    socket_.shutdown(ip::tcp::socket::shutdown_both, ignored);
+                    socket_.close(ignored);
+                    return;
+                }
+
+                send();
+                read();
+            });
+        }
+
+        // NOTE: Сервер закрыл соединение раньше времени. Отправка (если она идёт) завершится с ошибкой сама.
+        void fail()
+        {
+            if (socket_.is_open()) {
+                boost::system::error_code ignored;
+                socket_.close(ignored);
+                ++worker_.failed;
+            }
+        }
+
+    private:
+        Worker& worker_;
+        const Options& options_;
+        const std::string& batch_;
+        const size_t messageSize_;
+
+        ip::tcp::socket socket_;
+        std::array<char, 64 * 1024> buffer_;
+        std::vector<Clock::time_point> sentAt_;
+
+        size_t sent_ = 0;
+        size_t received_ = 0;
+        uint64_t receivedBytes_ = 0;
+        bool writing_ = false;
+    };
+
+    /**
+     * @struct Result
+     * @brief Итоги нагрузки.
+     */
+    struct Result final
+    {
+        LatencyHistogram histogram;
+        size_t failed = 0;
+        double seconds = 0;
+        uint64_t bytes = 0;
+    };
+
+    void sendStop(const Options& options, const ip::tcp::endpoint& endpoint)
+    {
+        io_context context;
+        ip::tcp::socket socket(context);
+        socket.connect(endpoint);
+
+        constexpr std::string_view command = "SERVER_STOP";
+
+        if (options.protocol == "frames") {
+            const std::array<char, 4> header = { 0, 0, 0, static_cast<char>(command.size()) };
+            const std::array<const_buffer, 2> buffers = { buffer(header), buffer(command.data(), command.size()) };
+            write(socket, buffers);
+        } else {
+            write(socket, std::array<const_buffer, 2>{ buffer(command.data(), command.size()), buffer("\n", 1) });
+        }
+    }
+
+    /**
+     * @struct Percentile
+     * @brief Процентиль задержки в отчёте.
+     */
+    struct Percentile final
+    {
+        std::string_view name;
+        double percent;
+    };
+
+    constexpr std::array<Percentile, 4> PERCENTILES = { { { "p50", 50.0 }, { "p90", 90.0 }, { "p99", 99.0 }, { "p99.9", 99.9 } } };
+
+    double microseconds(uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+
+    void printTable(std::ostream& out, const Options& options, const Result& result)
+    {
+        const auto messages = static_cast<double>(result.histogram.count());
+
+        out << std::fixed << std::setprecision(3)
+            << "Connections: " << options.connections << ", messages: " << options.messages << " x " << options.size
+            << " B, depth: " << options.depth << ", protocol: " << options.protocol << "\n"
+            << "Time: " << result.seconds << " s, failed connections: " << result.failed << "\n"
+            << "Throughput: " << std::setprecision(0) << messages / result.seconds << " msg/s, "
+            << std::setprecision(3) << static_cast<double>(result.bytes) / result.seconds / (1024 * 1024) << " MiB/s" << "\n"
+            << std::setprecision(1)
+            << "Latency (us): min " << microseconds(result.histogram.min())
+            << ", mean " << result.histogram.mean() / 1000.0;
+
+        for (const Percentile& percentile : PERCENTILES) {
+            out << ", " << percentile.name << " " << microseconds(result.histogram.percentile(percentile.percent));
+        }
+
+        out << ", max " << microseconds(result.histogram.max()) << "\n";
+    }
+
+    void printJson(std::ostream& out, const Options& options, const Result& result)
+    {
+        const auto messages = static_cast<double>(result.histogram.count());
+
+        out << std::fixed << std::setprecision(3)
+            << "{\n"
+            << "  \"connections\": " << options.connections << ",\n"
+            << "  \"messages_per_connection\": " << options.messages << ",\n"
+            << "  \"message_size\": " << options.size << ",\n"
+            << "  \"depth\": " << options.depth << ",\n"
+            << "  \"protocol\": \"" << options.protocol << "\",\n"
+            << "  \"failed_connections\": " << result.failed << ",\n"
+            << "  \"messages\": " << result.histogram.count() << ",\n"
+            << "  \"real_time_ms\": " << result.seconds * 1000.0 << ",\n"
+            << "  \"messages_per_second\": " << messages / result.seconds << ",\n"
+            << "  \"bytes_per_second\": " << static_cast<double>(result.bytes) / result.seconds << ",\n"
+            << "  \"latency_us\": {\n"
+            << "    \"min\": " << microseconds(result.histogram.min()) << ",\n"
+            << "    \"mean\": " << result.histogram.mean() / 1000.0 << ",\n";
+
+        for (const Percentile& percentile : PERCENTILES) {
+            out << "    \"" << percentile.name << "\": " << microseconds(result.histogram.percentile(percentile.percent)) << ",\n";
+        }
+
+        out << "    \"max\": " << microseconds(result.histogram.max()) << "\n"
+            << "  }\n"
+            << "}\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--host <address>] [--port <port>] [--connections <M>] [--messages <K>] [--size <bytes>]"
+                  << " [--depth <in flight>] [--threads <count>] [--protocol lines|frames] [--json <file>] [--stop]" << "\n";
+        return 1;
+    }
+
+    if (options->protocol == "lines" && options->size < 2) {
+        std::cerr << "Line must contain at least one character besides '\\n'" << "\n";
+        return 1;
+    }
+
+    Result result;
+
+    try {
+        const ip::tcp::endpoint endpoint(ip::make_address(options->host), options->port);
+
+        const std::string message = makeMessage(*options);
+
+        // NOTE: Пачка из depth сообщений подряд: любые count из них отправляются одной записью.
+        std::string batch;
+        batch.reserve(message.size() * options->depth);
+
+        for (size_t i = 0; i < options->depth; ++i) {
+            batch += message;
+        }
+
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        for (size_t i = 0; i < std::min(options->threads, options->connections); ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+
+        // NOTE: Соединения устанавливаются заранее, чтобы время установки не попало в замер.
+        std::vector<std::unique_ptr<Client>> clients;
+
+        for (size_t i = 0; i < options->connections; ++i) {
+            auto client = std::make_unique<Client>(*workers[i % workers.size()], *options, batch, message.size());
+            client->connect(endpoint);
+            post(workers[i % workers.size()]->context, [client = client.get()] {
+                client->start();
+            });
+            clients.push_back(std::move(client));
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+
+        for (const auto& worker : workers) {
+            threads.emplace_back([&context = worker->context] {
+                context.run();
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        for (const auto& worker : workers) {
+            result.histogram.merge(worker->histogram);
+            result.failed += worker->failed;
+        }
+
+        result.bytes = result.histogram.count() * message.size();
+
+        if (options->stop) {
+            sendStop(*options, endpoint);
+        }
+    } catch (const std::exception& exception) {
+        std::cerr << "Error occurred: " << exception.what() << "\n";
+        return 1;
+    }
+
+    // NOTE: "--json -" - вывод JSON вместо таблицы на стандартный вывод.
+    if (options->json == "-") {
+        printJson(std::cout, *options, result);
+    } else {
+        if (options->json) {
+            std::ofstream file(*options->json, std::ios::out);
+            printJson(file, *options, result);
+        }
+
+        printTable(std::cout, *options, result);
+    }
+
+    return (result.failed == 0) ? 0 : 1;
+}
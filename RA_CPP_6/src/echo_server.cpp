@@ -1,35 +1,433 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-#include <boost/asio/io_service.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
+
+// NOTE: Сопрограммы asio (awaitable, co_spawn) доступны лишь при сборке в режиме C++20 (или с Coroutines TS).
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#endif
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+#include "BufferPool.h"
+#include "Connection.h"
+
+// NOTE: Движок на io_uring собирается лишь по опции WITH_IO_URING (только Linux).
+#if defined(ECHO_SERVER_WITH_IO_URING)
+#include "UringServer.h"
+#endif
+
 namespace fs = std::filesystem;
 
 using namespace boost::asio;
 
-namespace
+/**
+ * @class Session
+ * @brief Соединение с клиентом: асинхронно читает строки и отправляет их обратно.
+ *
+ * Все обработчики соединения выполняются в его собственном strand-е (см. Server::accept()),
+ * поэтому они никогда не выполняются одновременно, даже если io_context обслуживают несколько потоков.
+ * Объект живёт, пока есть незавершённая асинхронная операция (она владеет std::shared_ptr на него).
+ */
+class Session final : public Connection
 {
-    template<typename OStream, typename IStream, typename Transform>
-    void transform(OStream&& out, IStream&& in, Transform&& transform = Transform())
+public:
+    using Connection::Connection;
+
+    void start() override
+    {
+        read();
+    }
+
+private:
+    std::shared_ptr<Session> self()
+    {
+        return std::static_pointer_cast<Session>(shared_from_this());
+    }
+
+    void read()
     {
-        for (std::string line; std::getline(in, line);) {
-            out << transform(line) << "\n";
+        if (draining_) {
+            finish();
+            return;
         }
+
+        waiting_ = true;
+
+        // NOTE: Если в буфере уже есть полная строка, обработчик будет вызван без обращения к сокету.
+        async_read_until(socket_, buffer_, '\n', [self = self()](const boost::system::error_code& error, size_t size) {
+            self->waiting_ = false;
+
+            if (!error) {
+                self->echo(size);
+            } else if (self->draining_ && !self->aborted_ && error == error::operation_aborted) {
+                self->finish();
+            } else {
+                self->close();
+            }
+        });
     }
-}
 
+    void echo(size_t size)
+    {
+        const std::string_view line(static_cast<const char*>(buffer_.data().data()), size - 1);
+
+        if (line == "SERVER_STOP") {
+            owner_.requestStop();
+            close();
+            return;
+        }
+
+        // NOTE: Отправляем строку (вместе с '\n') прямо из буфера чтения, без копирования.
+        async_write(socket_, buffer(buffer_.data(), size), [self = self()](const boost::system::error_code& error, size_t size) {
+            if (error) {
+                self->close();
+                return;
+            }
+
+            self->bytes_ += size;
+            self->buffer_.consume(size);
+            self->read();
+        });
+    }
+
+    // NOTE: Сервер останавливается. Дочитываем уже пришедшие данные, отправляем все полные строки и закрываем соединение.
+    void finish()
+    {
+        boost::system::error_code error;
+
+        for (size_t available; (available = socket_.available(error)) > 0 && !error && buffer_.size() < buffer_.max_size();) {
+            const size_t size = socket_.read_some(buffer_.prepare(std::min(available, buffer_.max_size() - buffer_.size())), error);
+            buffer_.commit(size);
+        }
+
+        const std::string_view data(static_cast<const char*>(buffer_.data().data()), buffer_.size());
+        const size_t last = data.rfind('\n');
+
+        if (last == std::string_view::npos) {
+            close();
+            return;
+        }
+
+        // NOTE: Пока отправляли, могли прийти новые данные - продолжаем, пока есть полные строки.
+        async_write(socket_, buffer(buffer_.data(), last + 1), [self = self()](const boost::system::error_code& error, size_t size) {
+            if (error) {
+                self->close();
+                return;
+            }
+
+            self->bytes_ += size;
+            self->buffer_.consume(size);
+            self->finish();
+        });
+    }
+
+private:
+    // NOTE: Ограничиваем длину строки, чтобы клиент без '\n' не мог занять всю память сервера.
+    static constexpr size_t MAX_LINE = 64 * 1024;
+
+    streambuf buffer_{ MAX_LINE };
+};
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
 /**
- * @struct StopServerExeption
- * @brief Пользовательское исключение для остановки сервера.
+ * @class CoroutineSession
+ * @brief Соединение с клиентом, обслуживаемое сопрограммой (по протоколу строк или кадров).
+ *
+ * Вариант Session в виде сопрограммы: вместо цепочки обработчиков - один кадр сопрограммы на клиента.
+ * Простаивающее соединение ждёт лишь готовности сокета к чтению и не держит буфер:
+ * буфер берётся из пула на время чтения.
+ *
+ * @note Сопрограммы - awaitable из asio, а не Task<T> из RA_CPP_8: Task<T> запускается сразу и не возобновляет
+ *       ожидающую его сопрограмму, а исключения в нём завершают программу. Асинхронные операции asio
+ *       возобновляют сопрограмму через use_awaitable в исполнителе (strand-е) соединения, и ошибки сокета
+ *       приходят в неё как исключения или коды ошибок.
  */
-struct StopServerExeption final : std::exception {};
+class CoroutineSession final : public Connection
+{
+public:
+    enum class Protocol
+    {
+        Lines,
+        Frames
+    };
+
+    CoroutineSession(ip::tcp::socket socket, ConnectionOwner& owner, BufferPool& pool, Protocol protocol)
+        : Connection(std::move(socket), owner)
+        , pool_(pool)
+        , protocol_(protocol)
+    {}
+
+    void start() override
+    {
+        auto self = std::static_pointer_cast<CoroutineSession>(shared_from_this());
+
+        // NOTE: Сопрограмма выполняется в strand-е сокета, как и задачи drain() и abort().
+        const auto executor = socket_.get_executor();
+
+        if (protocol_ == Protocol::Frames) {
+            co_spawn(executor, serveFrames(std::move(self)), detached);
+        } else {
+            co_spawn(executor, serveLines(std::move(self)), detached);
+        }
+    }
+
+private:
+    /**
+     * @brief Проверяет, составляют ли две части строки команду остановки сервера.
+     */
+    static bool isStopCommand(std::string_view head, std::string_view tail) noexcept
+    {
+        constexpr std::string_view command = "SERVER_STOP";
+
+        return (head.size() + tail.size() == command.size())
+            && (command.substr(0, head.size()) == head)
+            && (command.substr(head.size()) == tail);
+    }
+
+    /**
+     * @brief Ждёт данных от клиента.
+     * @return false, если соединение пора закрыть (ошибка или остановка сервера, а непрочитанных данных нет)
+     */
+    awaitable<bool> readable()
+    {
+        boost::system::error_code error;
+
+        if (!draining_) {
+            waiting_ = true;
+            co_await socket_.async_wait(socket_base::wait_read, redirect_error(use_awaitable, error));
+            waiting_ = false;
+
+            if (error && !draining_) {
+                co_return false;
+            }
+        }
+
+        // NOTE: При остановке сервера новых данных не ждём, но уже пришедшие обрабатываем.
+        co_return !draining_ || (socket_.available(error) > 0 && !error);
+    }
+
+    /**
+     * @brief Обслуживает соединение по протоколу строк: читает строки и отправляет их обратно.
+     * @param self указатель на это же соединение: продлевает его жизнь до завершения сопрограммы
+     * @note Между чтениями хранится лишь недочитанная часть строки (обычно пустая).
+     */
+    awaitable<void> serveLines([[maybe_unused]] std::shared_ptr<CoroutineSession> self)
+    {
+        constexpr size_t MAX_LINE = 64 * 1024;
+
+        std::string pending; // NOTE: Начало строки, конец которой ещё не пришёл.
+
+        try {
+            while (co_await readable()) {
+                const BufferPool::Buffer chunk = pool_.acquire();
+                const size_t size = co_await socket_.async_read_some(buffer(chunk.data(), pool_.blockSize()), use_awaitable);
+
+                // NOTE: Отправляем все полные строки одной записью; команду остановки проверяем в каждой из них.
+                const std::string_view data(chunk.data(), size);
+                const size_t last = data.rfind('\n');
+
+                if (last == std::string_view::npos) {
+                    pending.append(data);
+                } else {
+                    size_t begin = 0;
+                    bool stop = false;
+
+                    while (begin <= last) {
+                        const size_t end = data.find('\n', begin);
+
+                        // NOTE: Начало первой строки могло прийти ещё при прошлом чтении.
+                        if (isStopCommand((begin == 0) ? pending : std::string_view(), data.substr(begin, end - begin))) {
+                            stop = true;
+                            break;
+                        }
+
+                        begin = end + 1;
+                    }
+
+                    if (stop && begin == 0) {
+                        pending.clear();
+                    }
+
+                    const std::array<const_buffer, 2> buffers = { buffer(pending), buffer(data.data(), begin) };
+                    bytes_ += co_await async_write(socket_, buffers, use_awaitable);
+
+                    if (stop) {
+                        owner_.requestStop();
+                        break;
+                    }
+
+                    pending.assign(data.substr(last + 1));
+                }
+
+                if (pending.size() > MAX_LINE) {
+                    break;
+                }
+
+                // NOTE: Не держим память простаивающего соединения.
+                if (pending.empty()) {
+                    pending.shrink_to_fit();
+                }
+            }
+        } catch (const boost::system::system_error&) {
+            // NOTE: Клиент закрыл соединение или произошла ошибка сети - просто завершаем сопрограмму.
+        }
+
+        close();
+    }
+
+    /**
+     * @brief Обслуживает соединение по протоколу кадров: каждый кадр отправляется обратно без изменений.
+     *
+     * Кадр - длина данных (4 байта, сетевой порядок) и сами данные. Данные читаются в блоки из пула
+     * и отправляются прямо из них: кадр, начатый в одном блоке и законченный в следующем, отправляется
+     * одной записью из двух буферов (scatter/gather), без склейки. Поэтому кадр не длиннее блока
+     * занимает не более двух блоков, а память на каждое сообщение не выделяется.
+     * Простаивающее соединение блоков не держит. Кадр с данными "SERVER_STOP" - команда остановки сервера.
+     */
+    awaitable<void> serveFrames([[maybe_unused]] std::shared_ptr<CoroutineSession> self)
+    {
+        constexpr size_t HEADER_SIZE = 4;
+        constexpr std::string_view STOP_COMMAND = "SERVER_STOP";
+
+        const size_t blockSize = pool_.blockSize();
+        const size_t maxFrame = blockSize - HEADER_SIZE;
+
+        std::array<BufferPool::Buffer, 2> blocks;
+        size_t count = 0;  // NOTE: Сколько блоков занято.
+        size_t begin = 0;  // NOTE: Начало неотправленных данных в первом блоке.
+        size_t filled = 0; // NOTE: Заполненная часть последнего блока.
+
+        try {
+            while (co_await readable()) {
+                if (count == 0) {
+                    blocks[0] = pool_.acquire();
+                    count = 1;
+                    begin = 0;
+                    filled = 0;
+                } else if (filled == blockSize) {
+                    if (count == blocks.size()) {
+                        break;
+                    }
+
+                    blocks[count++] = pool_.acquire();
+                    filled = 0;
+                }
+
+                filled += co_await socket_.async_read_some(buffer(blocks[count - 1].data() + filled, blockSize - filled), use_awaitable);
+
+                // NOTE: Неотправленные данные - это [begin, конец первого блока) и, возможно, [0, filled) второго.
+                const size_t head = ((count == 1) ? filled : blockSize) - begin;
+                const size_t total = (count == 1) ? head : head + filled;
+
+                auto byteAt = [&](size_t offset) {
+                    return static_cast<uint8_t>((offset < head) ? blocks[0].data()[begin + offset] : blocks[1].data()[offset - head]);
+                };
+
+                size_t complete = 0;
+                bool stop = false;
+
+                while (complete + HEADER_SIZE <= total) {
+                    size_t length = 0;
+
+                    for (size_t i = 0; i < HEADER_SIZE; ++i) {
+                        length = (length << 8) | byteAt(complete + i);
+                    }
+
+                    if (length > maxFrame) {
+                        throw std::length_error("Frame is too long");
+                    }
 
-class Server final
+                    if (complete + HEADER_SIZE + length > total) {
+                        break;
+                    }
+
+                    if (length == STOP_COMMAND.size()) {
+                        stop = true;
+
+                        for (size_t i = 0; i < length && stop; ++i) {
+                            stop = (byteAt(complete + HEADER_SIZE + i) == static_cast<uint8_t>(STOP_COMMAND[i]));
+                        }
+
+                        if (stop) {
+                            break;
+                        }
+                    }
+
+                    complete += HEADER_SIZE + length;
+                }
+
+                if (complete > 0) {
+                    const std::array<const_buffer, 2> buffers = {
+                        buffer(blocks[0].data() + begin, std::min(complete, head)),
+                        buffer(blocks[1].data(), (complete > head) ? complete - head : 0)
+                    };
+
+                    bytes_ += co_await async_write(socket_, buffers, use_awaitable);
+                }
+
+                if (stop) {
+                    owner_.requestStop();
+                    break;
+                }
+
+                // NOTE: Возвращаем в пул полностью отправленные блоки.
+                begin += complete;
+
+                if (count == 2 && begin >= blockSize) {
+                    begin -= blockSize;
+                    blocks[0] = std::move(blocks[1]);
+                    count = 1;
+                }
+
+                if (count == 1 && begin == filled) {
+                    blocks[0].reset();
+                    count = 0;
+                }
+            }
+        } catch (const std::exception&) {
+            // NOTE: Клиент закрыл соединение, прислал некорректный кадр или произошла ошибка сети - завершаем сопрограмму.
+        }
+
+        close();
+    }
+
+private:
+    BufferPool& pool_;
+    Protocol protocol_;
+};
+#endif
+
+class Server final : public ConnectionOwner
 {
 public:
     Server() = default;
@@ -49,43 +447,296 @@ public:
             ip::address::from_string(tree.get<std::string>("network.host")),
             tree.get<uint16_t>("network.port")
         );
+
+        // NOTE: Необязательные настройки: число потоков, обслуживающих соединения, и длина очереди входящих соединений.
+        threads_ = std::max<size_t>(tree.get<size_t>("network.threads", std::thread::hardware_concurrency()), 1);
+        backlog_ = tree.get<int>("network.backlog", socket_base::max_listen_connections);
+
+        // NOTE: Способ обслуживания соединений: "coroutines" (по умолчанию, если доступны), "callbacks" или "uring".
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+        const std::string engine = tree.get<std::string>("network.engine", "coroutines");
+        [[maybe_unused]] const Engine fallback = Engine::Coroutines;
+#else
+        const std::string engine = tree.get<std::string>("network.engine", "callbacks");
+        [[maybe_unused]] const Engine fallback = Engine::Callbacks;
+#endif
+
+        if (engine == "callbacks") {
+            engine_ = Engine::Callbacks;
+        } else if (engine == "coroutines") {
+#if !defined(BOOST_ASIO_HAS_CO_AWAIT)
+            throw std::runtime_error("Coroutines are not supported by this build");
+#endif
+            engine_ = Engine::Coroutines;
+        } else if (engine == "uring") {
+#if !defined(ECHO_SERVER_WITH_IO_URING)
+            throw std::runtime_error("io_uring is not supported by this build");
+#else
+            try {
+                UringServer::probe();
+                engine_ = Engine::Uring;
+            } catch (const std::exception& exception) {
+                // NOTE: Ядро без нужных возможностей io_uring (или io_uring запрещён) - работаем через asio.
+                std::cerr << "io_uring is unavailable (" << exception.what() << "), falling back to asio" << "\n";
+                engine_ = fallback;
+            }
+#endif
+        } else {
+            throw std::runtime_error("Unknown network engine: " + engine);
+        }
+
+        // NOTE: Протокол: "lines" (строки, режим совместимости, по умолчанию) или "frames" (кадры с длиной).
+        const std::string protocol = tree.get<std::string>("network.protocol", "lines");
+
+        if (protocol == "lines") {
+            framed_ = false;
+        } else if (protocol == "frames") {
+            framed_ = true;
+        } else {
+            throw std::runtime_error("Unknown network protocol: " + protocol);
+        }
+
+        if (framed_ && engine_ == Engine::Uring) {
+            throw std::runtime_error("Framed protocol is not supported by the io_uring engine");
+        }
+
+        if (framed_ && engine_ != Engine::Coroutines) {
+            throw std::runtime_error("Framed protocol requires the coroutines engine");
+        }
+
+        // NOTE: Размер блока буфера определяет и максимальную длину кадра.
+        bufferSize_ = std::max<size_t>(tree.get<size_t>("network.buffer_size", bufferSize_), 64);
+
+        // NOTE: Сколько времени (в миллисекундах) при остановке даётся соединениям, чтобы отправить ответы.
+        shutdownTimeout_ = std::chrono::milliseconds(tree.get<int64_t>("network.shutdown_timeout", shutdownTimeout_.count()));
     }
 
     /**
-     * @brief Запускает сервер.
-     * @warning Корректный выход из функции возможен лишь при выбросе исключения.
+     * @brief Запускает сервер и обслуживает клиентов до остановки.
+     *
+     * Сервер останавливается командой SERVER_STOP от любого клиента или сигналом SIGINT/SIGTERM.
+     * При остановке новые соединения не принимаются, а открытые завершаются, отправив ответы на уже полученные данные.
+     * Соединения, не успевшие завершиться за отведённое время (network.shutdown_timeout), закрываются принудительно.
+     *
+     * @return итоги работы сервера
      */
-    [[noreturn]] void start()
+    ServerStats start()
     {
+        const auto begin = std::chrono::steady_clock::now();
+
+#if defined(ECHO_SERVER_WITH_IO_URING)
+        // NOTE: Движок на io_uring обслуживает соединения сам, без io_context.
+        if (engine_ == Engine::Uring) {
+            UringServer server(endpoint_, threads_, backlog_, bufferSize_, shutdownTimeout_);
+
+            std::cout << "Service started" << std::endl;
+
+            ServerStats stats = server.run();
+
+            std::cout << "Service stopped" << std::endl;
+
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            return stats;
+        }
+#endif
+
+        pool_ = std::make_unique<BufferPool>(bufferSize_, MAX_CACHED_BUFFERS);
+
+        acceptor_.open(endpoint_.protocol());
+        acceptor_.set_option(ip::tcp::acceptor::reuse_address(true));
+        acceptor_.bind(endpoint_);
+        acceptor_.listen(backlog_);
+
+        accept();
+
+        signals_.async_wait([this](const boost::system::error_code& error, int) {
+            if (!error) {
+                requestStop();
+            }
+        });
+
         std::cout << "Service started" << std::endl;
 
-        ip::tcp::iostream stream;
-        ip::tcp::acceptor acceptor(service_, endpoint_);
+        // NOTE: Обработчики всех соединений выполняет пул потоков; вызывающий поток - один из них.
+        // io_context завершает работу сам, когда после остановки не остаётся ни одной операции.
+        std::vector<std::thread> threads;
+
+        for (size_t i = 1; i < threads_; ++i) {
+            threads.emplace_back([this] {
+                context_.run();
+            });
+        }
+
+        std::exception_ptr error;
+
+        try {
+            context_.run();
+        } catch (...) {
+            error = std::current_exception();
+            context_.stop();
+        }
 
-        // NOTE: Принимаем входящее соединение и связываем его с потоком.
-        acceptor.accept(*stream.rdbuf());
+        std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
 
-        while (true) {
-            transform(stream, stream, [](std::string_view line) {
-                if (line == "SERVER_STOP") {
-                    // NOTE: Выходим из функции, выбросив исключение остановки сервера.
-                    throw StopServerExeption();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        std::cout << "Service stopped" << std::endl;
+
+        const std::lock_guard lock(mutex_);
+        stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        return stats_;
+    }
+
+    /**
+     * @brief Начинает остановку сервера.
+     * @note Можно вызывать из любого потока, в том числе повторно.
+     */
+    void requestStop() override
+    {
+        if (stopping_.exchange(true)) {
+            return;
+        }
+
+        post(control_, [this] {
+            boost::system::error_code error;
+            acceptor_.close(error);
+            signals_.cancel(error);
+
+            std::vector<std::shared_ptr<Connection>> connections;
+
+            {
+                const std::lock_guard lock(mutex_);
+
+                for (const auto& [pointer, connection] : connections_) {
+                    connections.push_back(connection);
                 }
+            }
+
+            if (connections.empty()) {
+                return;
+            }
+
+            std::for_each(connections.begin(), connections.end(), std::mem_fn(&Connection::drain));
+
+            // NOTE: Соединения, не завершившиеся к сроку, закрываем принудительно.
+            deadline_.expires_after(shutdownTimeout_);
+            deadline_.async_wait([this](const boost::system::error_code& error) {
+                if (error) {
+                    return;
+                }
+
+                const std::lock_guard lock(mutex_);
 
-                return line;
+                for (const auto& [pointer, connection] : connections_) {
+                    connection->abort();
+                }
+            });
+        });
+    }
+
+private:
+    void onClosed(const Connection& connection) override
+    {
+        const std::lock_guard lock(mutex_);
+
+        stats_.bytes += connection.bytes();
+
+        if (connection.aborted()) {
+            ++stats_.aborted;
+        } else if (stopping_) {
+            ++stats_.drained;
+        }
+
+        connections_.erase(&connection);
+
+        // NOTE: Все соединения завершились - ждать срока остановки больше незачем.
+        if (stopping_ && connections_.empty()) {
+            post(control_, [this] {
+                deadline_.cancel();
             });
         }
     }
 
-    void stop()
+    void accept()
     {
-        service_.stop();
-        std::cout << "Service stopped" << std::endl;
+        // NOTE: Каждое соединение получает собственный strand, по которому будут выполняться его обработчики
+        // (и запросы на завершение от сервера).
+        acceptor_.async_accept(make_strand(context_), [this](const boost::system::error_code& error, ip::tcp::socket socket) {
+            if (!acceptor_.is_open()) {
+                return;
+            }
+
+            if (error) {
+                // NOTE: Ошибка приёма (например, исчерпан лимит дескрипторов) не должна останавливать сервер.
+                std::cerr << "Accept failed: " << error.message() << "\n";
+            } else {
+                serve(std::move(socket));
+            }
+
+            accept();
+        });
+    }
+
+    void serve(ip::tcp::socket socket)
+    {
+        std::shared_ptr<Connection> connection;
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+        if (engine_ == Engine::Coroutines) {
+            const auto protocol = framed_ ? CoroutineSession::Protocol::Frames : CoroutineSession::Protocol::Lines;
+            connection = std::make_shared<CoroutineSession>(std::move(socket), *this, *pool_, protocol);
+        }
+#endif
+
+        if (!connection) {
+            connection = std::make_shared<Session>(std::move(socket), *this);
+        }
+
+        {
+            const std::lock_guard lock(mutex_);
+            connections_.emplace(connection.get(), connection);
+            ++stats_.connections;
+        }
+
+        connection->start();
     }
 
 private:
+    enum class Engine
+    {
+        Callbacks,
+        Coroutines,
+        Uring
+    };
+
+    // NOTE: Сколько свободных блоков держать в пуле про запас.
+    static constexpr size_t MAX_CACHED_BUFFERS = 256;
+
     ip::tcp::endpoint endpoint_;
-    io_service service_;
+    size_t threads_ = 1;
+    Engine engine_ = Engine::Callbacks;
+    bool framed_ = false;
+    int backlog_ = socket_base::max_listen_connections;
+    size_t bufferSize_ = 64 * 1024;
+    std::chrono::milliseconds shutdownTimeout_{ 5000 };
+
+    // NOTE: Пул объявлен раньше io_context: сопрограммы, владеющие блоками, уничтожаются вместе с io_context.
+    std::unique_ptr<BufferPool> pool_;
+    io_context context_;
+
+    // NOTE: Приём соединений, сигналы и остановка сервера обрабатываются в одном strand-е и не пересекаются.
+    strand<io_context::executor_type> control_{ make_strand(context_) };
+    ip::tcp::acceptor acceptor_{ control_ };
+    signal_set signals_{ control_, SIGINT, SIGTERM };
+    steady_timer deadline_{ control_ };
+    std::atomic<bool> stopping_ = false;
+
+    std::mutex mutex_;
+    std::unordered_map<const Connection*, std::shared_ptr<Connection>> connections_;
+    ServerStats stats_;
 };
 
 int main()
@@ -94,13 +745,13 @@ int main()
 
     try {
         server.configure("EchoServer.conf");
-        server.start();
-    } catch (const StopServerExeption&) {
-        // NOTE: Корректно останавливаем сервер и завершаем программу.
-        server.stop();
+
+        const ServerStats stats = server.start();
+        std::cout << stats << "\n";
     } catch (const std::exception& exception) {
-        // NOTE: Все остальные исключения считаем ошибками. Выводим информацию о них и корректно завершаем программу.
+        // NOTE: Выводим информацию об ошибке и корректно завершаем программу.
         std::cerr << "Error occurred: " << exception.what() << "\n";
+        return 1;
     }
 
     return 0;
@@ -2,7 +2,8 @@
 #include <iostream>
 #include <optional>
 #include <string>
-#include <unordered_map>
+
+#include "HashMap.h"
 
 using namespace std::literals;
 
@@ -39,7 +40,7 @@ public:
     }
 
 private:
-    std::unordered_map<std::string, std::any> storage_;
+    HashMap<std::string, std::any> storage_;
 };
 
 struct User
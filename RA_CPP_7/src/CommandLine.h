@@ -0,0 +1,30 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+// NOTE: Разбор числовых параметров командной строки замеров. В отличие от std::stoul, неверное значение
+// ("abc", "12x", "-1", переполнение) не выбрасывает исключение, а сообщается результатом.
+
+/**
+ * @brief Записывает в target целое число, если оно записано в text целиком и лежит в [minimum, maximum].
+ * @return false, если значение неверное (target при этом не изменяется)
+ */
+inline bool parseNumber(std::string_view text,
+                        size_t& target,
+                        size_t minimum = 1,
+                        size_t maximum = std::numeric_limits<size_t>::max()) noexcept
+{
+    size_t number = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+
+    if (error != std::errc() || end != text.data() + text.size() || number < minimum || number > maximum) {
+        return false;
+    }
+
+    target = number;
+    return true;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "LockOrder.h"
+#include "LockProfiler.h"
+
+/**
+ * @class LogPolicy
+ * @brief Политика DebugMutex: выводит в stdout информацию о каждой блокировке.
+ * @warning Вывод с std::endl упорядочивает потоки и сам меняет поведение программы. Для замеров - ProfilePolicy.
+ */
+class LogPolicy
+{
+public:
+    explicit LogPolicy(std::string_view label)
+        : label_(label)
+    {}
+
+    void acquiring()
+    {}
+
+    void locked(bool /* contended */, std::chrono::nanoseconds /* wait */)
+    {
+        std::cout << label_ << " locked from " << std::this_thread::get_id() << std::endl;
+    }
+
+    void unlocking()
+    {
+        std::cout << label_ << " unlocked from " << std::this_thread::get_id() << std::endl;
+    }
+
+private:
+    std::string label_;
+};
+
+/**
+ * @class ProfilePolicy
+ * @brief Политика DebugMutex: копит статистику блокировок в LockProfiler, сводка печатается при завершении программы.
+ */
+class ProfilePolicy
+{
+public:
+    explicit ProfilePolicy(std::string_view label)
+        : label_(LockProfiler::instance().registerLabel(label))
+    {}
+
+    void acquiring()
+    {}
+
+    void locked(bool contended, std::chrono::nanoseconds wait)
+    {
+        LockProfiler::Statistics& statistics = LockProfiler::local(label_);
+
+        ++statistics.acquisitions;
+        statistics.contended += contended;
+        statistics.wait.record(wait);
+
+        // NOTE: Момент захвата пишет и читает лишь владелец мьютекса.
+        lockedAt_ = std::chrono::steady_clock::now();
+    }
+
+    void unlocking()
+    {
+        LockProfiler::local(label_).hold.record(std::chrono::steady_clock::now() - lockedAt_);
+    }
+
+private:
+    const size_t label_;
+    std::chrono::steady_clock::time_point lockedAt_;
+};
+
+/**
+ * @class LockOrderPolicy
+ * @brief Политика DebugMutex: проверяет порядок захвата мьютексов (см. LockOrder) и сообщает о возможных
+ *        взаимных блокировках в stderr.
+ */
+class LockOrderPolicy
+{
+public:
+    explicit LockOrderPolicy(std::string_view label)
+        : label_(LockOrder::instance().registerLabel(label))
+    {}
+
+    // NOTE: Проверяем до захвата: после него поток, возможно, уже никогда не проснётся.
+    void acquiring()
+    {
+        LockOrder::instance().acquiring(this, label_);
+    }
+
+    void locked(bool /* contended */, std::chrono::nanoseconds /* wait */)
+    {
+        LockOrder::instance().acquired(this, label_);
+    }
+
+    void unlocking()
+    {
+        LockOrder::instance().released(this);
+    }
+
+private:
+    const size_t label_;
+};
+
+/**
+ * @class DebugMutex
+ * @brief Отладочная обёртка над мьютексом. Что делать при блокировках, решает политика.
+ * @tparam Policy LogPolicy (вывод в stdout), ProfilePolicy (статистика ожидания и удержания)
+ *         или LockOrderPolicy (проверка порядка захвата)
+ */
+template<typename Mutex, typename Policy = LogPolicy>
+class DebugMutex final : private Mutex
+{
+public:
+    explicit DebugMutex(std::string_view label)
+        : policy_(label)
+    {}
+
+    void lock()
+    {
+        policy_.acquiring();
+
+        // NOTE: Сначала пробуем захватить без ожидания: так без лишних замеров времени отличаем захват
+        // свободного мьютекса от захвата с ожиданием.
+        if (Mutex::try_lock()) {
+            policy_.locked(false, std::chrono::nanoseconds::zero());
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        Mutex::lock();
+        policy_.locked(true, std::chrono::steady_clock::now() - start);
+    }
+
+    bool try_lock()
+    {
+        if (!Mutex::try_lock()) {
+            return false;
+        }
+
+        policy_.locked(false, std::chrono::nanoseconds::zero());
+        return true;
+    }
+
+    void unlock()
+    {
+        policy_.unlocking();
+        Mutex::unlock();
+    }
+
+private:
+    Policy policy_;
+};
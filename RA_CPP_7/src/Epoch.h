@@ -0,0 +1,236 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#ifdef __linux__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// NOTE: Освобождение памяти по эпохам (epoch-based reclamation). Писатель убирает объект из структуры данных,
+// но удаляет его лишь тогда, когда ни один читатель, начавший чтение до этого, уже не может держать на него указатель.
+// Читатели при этом не захватывают блокировок и пишут только в свою ячейку.
+
+/**
+ * @class EpochDomain
+ * @brief Глобальный счётчик эпох и ячейки читающих потоков.
+ *
+ * Каждый поток при первом чтении получает свою ячейку (в отдельной строке кэша) и на время чтения записывает в неё
+ * текущую эпоху. Ячейки не удаляются, а освобождаются при завершении потока и достаются следующим потокам.
+ */
+class EpochDomain final
+{
+public:
+    static constexpr uint64_t INACTIVE = 0;
+
+    static EpochDomain& instance()
+    {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    EpochDomain(const EpochDomain& other) = delete;
+    EpochDomain& operator=(const EpochDomain& other) = delete;
+
+    ~EpochDomain()
+    {
+        for (Slot* slot = slots_.load(); slot != nullptr;) {
+            Slot* const next = slot->next;
+            delete slot;
+            slot = next;
+        }
+    }
+
+    /**
+     * @brief Отмечает начало чтения текущим потоком.
+     */
+    void enter() noexcept
+    {
+        std::atomic<uint64_t>& epoch = localSlot().epoch;
+
+        // NOTE: acquire: указатели из структуры данных читаются не раньше эпохи. Иначе на процессоре со слабым
+        // порядком (ARM) поток мог бы прочитать указатель на объект, убранный в эпохе R, а объявить эпоху R + 1 -
+        // и safeEpoch() разрешил бы удалить объект, пока поток его читает. На x86 это обычная загрузка.
+        // release: писатель, прочитавший новую эпоху, видит и все чтения потока под прошлыми EpochGuard -
+        // иначе удаление объекта, прочитанного раньше, формально не упорядочено с этим чтением (и TSan сообщит о гонке).
+        epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_release);
+
+        // NOTE: Запись эпохи должна стать видна писателям раньше, чем поток прочитает указатели из структуры данных:
+        // тогда писатель либо увидит эпоху читателя, либо читатель уже не увидит убранный писателем объект.
+        // Этот порядок записи и последующих чтений (store-load) не дают ни acquire, ни release. С асимметричным
+        // барьером его обеспечивает барьер в процессоре, который за читателя выполнит safeEpoch(), а читателю
+        // остаётся запретить перестановку компилятору. Порядок загрузки эпохи и чтений обеспечивает acquire выше.
+        if (asymmetric_) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * @brief Отмечает конец чтения текущим потоком.
+     */
+    void leave() noexcept
+    {
+        localSlot().epoch.store(INACTIVE, std::memory_order_release);
+    }
+
+    /**
+     * @brief Начинает новую эпоху. Вызывается после того, как объект убран из структуры данных.
+     * @return эпоха, в которой объект был убран: его можно удалить, когда safeEpoch() станет больше неё
+     */
+    uint64_t retire() noexcept
+    {
+        return epoch_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Наименьшая эпоха среди читающих потоков: все объекты, убранные в более ранних эпохах, можно удалить.
+     */
+    uint64_t safeEpoch() const noexcept
+    {
+        heavyFence();
+
+        uint64_t minimum = std::numeric_limits<uint64_t>::max();
+
+        for (const Slot* slot = slots_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+            const uint64_t epoch = slot->epoch.load(std::memory_order_acquire);
+
+            if (epoch != INACTIVE && epoch < minimum) {
+                minimum = epoch;
+            }
+        }
+
+        return minimum;
+    }
+
+private:
+    /**
+     * @struct Slot
+     * @brief Ячейка читающего потока. Занимает отдельную строку кэша, чтобы потоки не мешали друг другу.
+     */
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch = INACTIVE;
+        std::atomic<bool> used = true;
+        Slot* next = nullptr;
+    };
+
+    /**
+     * @struct Registration
+     * @brief Ячейка, закреплённая за потоком до его завершения.
+     */
+    struct Registration
+    {
+        Slot* slot = nullptr;
+
+        ~Registration()
+        {
+            if (slot != nullptr) {
+                slot->epoch.store(INACTIVE, std::memory_order_release);
+                slot->used.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    EpochDomain() noexcept
+        : asymmetric_(registerHeavyFence())
+    {}
+
+    /**
+     * @brief Разрешает процессу асимметричный барьер (membarrier).
+     * @return false, если ядро его не поддерживает: тогда барьер в процессоре выполняет каждый читатель
+     */
+    static bool registerHeavyFence() noexcept
+    {
+#ifdef __linux__
+        return ::syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Барьер в процессоре на стороне писателя.
+     *
+     * С membarrier ядро выполняет барьер на каждом ядре, где сейчас работает поток процесса: запись эпохи любым
+     * читателем либо уже видна, либо его чтения указателей ещё не начались. Так дорогой барьер (рассылка прерываний
+     * по ядрам, единицы микросекунд) переносится с каждого чтения на редкие проходы писателя по ячейкам.
+     */
+    void heavyFence() const noexcept
+    {
+#ifdef __linux__
+        if (asymmetric_) {
+            ::syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+            return;
+        }
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    Slot& localSlot()
+    {
+        thread_local Registration registration;
+
+        if (registration.slot == nullptr) {
+            registration.slot = acquire();
+        }
+
+        return *registration.slot;
+    }
+
+    Slot* acquire()
+    {
+        for (Slot* slot = slots_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+            bool used = false;
+
+            if (!slot->used.load(std::memory_order_relaxed)
+                && slot->used.compare_exchange_strong(used, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+
+        // NOTE: Свободных ячеек нет - добавляем новую в начало списка.
+        auto* const slot = new Slot;
+        slot->next = slots_.load(std::memory_order_relaxed);
+
+        while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+
+        return slot;
+    }
+
+private:
+    const bool asymmetric_; // NOTE: Барьер в процессоре выполняют писатели через membarrier, а не читатели.
+    std::atomic<uint64_t> epoch_ = INACTIVE + 1;
+    std::atomic<Slot*> slots_ = nullptr;
+};
+
+/**
+ * @class EpochGuard
+ * @brief Отмечает чтение текущим потоком на время своей жизни (RAII).
+ * @note Вложенные EpochGuard в одном потоке не поддерживаются.
+ */
+class EpochGuard final
+{
+public:
+    EpochGuard() noexcept
+        : domain_(EpochDomain::instance())
+    {
+        domain_.enter();
+    }
+
+    EpochGuard(const EpochGuard& other) = delete;
+    EpochGuard& operator=(const EpochGuard& other) = delete;
+
+    ~EpochGuard()
+    {
+        domain_.leave();
+    }
+
+private:
+    EpochDomain& domain_;
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @class LockOrder
+ * @brief Проверка порядка захвата мьютексов во время работы программы (по мотивам lockdep из ядра Linux).
+ *
+ * Мьютексы с одинаковой меткой образуют один класс. Если поток захватывает мьютекс класса B, удерживая мьютекс
+ * класса A, в глобальный граф добавляется ребро A -> B. Цикл в графе означает, что потоки захватывают мьютексы
+ * в разном порядке и могут заблокировать друг друга - об этом сообщается сразу, даже если взаимная блокировка
+ * на этот раз не случилась. Повторный захват потоком уже удерживаемого им мьютекса тоже обнаруживается.
+ *
+ * Каждое ребро проверяется один раз: поток помнит уже проверенные им рёбра, и повторяющийся порядок захвата
+ * не обращается к глобальному графу и не захватывает его мьютекс.
+ */
+class LockOrder final
+{
+public:
+    static LockOrder& instance()
+    {
+        static LockOrder order;
+        return order;
+    }
+
+    LockOrder(const LockOrder& other) = delete;
+    LockOrder& operator=(const LockOrder& other) = delete;
+
+    /**
+     * @return номер класса мьютексов с указанной меткой
+     */
+    size_t registerLabel(std::string_view label)
+    {
+        std::lock_guard lock(mutex_);
+
+        const auto it = std::find(labels_.begin(), labels_.end(), label);
+
+        if (it != labels_.end()) {
+            return static_cast<size_t>(it - labels_.begin());
+        }
+
+        labels_.emplace_back(label);
+        edges_.emplace_back();
+
+        return labels_.size() - 1;
+    }
+
+    /**
+     * @brief Проверяет захват мьютекса до того, как поток начнёт его ждать.
+     */
+    void acquiring(const void* mutex, size_t label)
+    {
+        const std::vector<Held>& held = heldLocks();
+
+        if (held.empty()) {
+            return;
+        }
+
+        const bool relocking = std::any_of(held.begin(), held.end(), [mutex](const Held& lock) {
+            return lock.mutex == mutex;
+        });
+
+        if (relocking) {
+            reportRelocking(label);
+        }
+
+        std::unordered_set<uint64_t>& checked = checkedEdges();
+
+        for (const Held& lock : held) {
+            // NOTE: Вложенные захваты мьютексов одного класса (например, двух разных пользователей) не упорядочены.
+            if (lock.label == label) {
+                continue;
+            }
+
+            const uint64_t edge = (static_cast<uint64_t>(lock.label) << 32) | label;
+
+            if (checked.insert(edge).second) {
+                addEdge(lock.label, label);
+            }
+        }
+    }
+
+    /**
+     * @brief Отмечает, что поток удерживает мьютекс.
+     */
+    void acquired(const void* mutex, size_t label)
+    {
+        heldLocks().push_back({ mutex, label });
+    }
+
+    /**
+     * @brief Отмечает, что поток освободил мьютекс (не обязательно захваченный последним).
+     */
+    void released(const void* mutex)
+    {
+        std::vector<Held>& held = heldLocks();
+
+        const auto it = std::find_if(held.rbegin(), held.rend(), [mutex](const Held& lock) {
+            return lock.mutex == mutex;
+        });
+
+        if (it != held.rend()) {
+            held.erase(std::next(it).base());
+        }
+    }
+
+private:
+    /**
+     * @struct Held
+     * @brief Мьютекс, удерживаемый потоком.
+     */
+    struct Held
+    {
+        const void* mutex;
+        size_t label;
+    };
+
+    /**
+     * @struct Edge
+     * @brief Ребро графа: порядок захвата и то, где он впервые встретился (поток и удерживаемые им мьютексы).
+     */
+    struct Edge
+    {
+        size_t to;
+        std::string witness;
+    };
+
+    LockOrder() = default;
+
+    static std::vector<Held>& heldLocks()
+    {
+        thread_local std::vector<Held> held;
+        return held;
+    }
+
+    static std::unordered_set<uint64_t>& checkedEdges()
+    {
+        thread_local std::unordered_set<uint64_t> checked;
+        return checked;
+    }
+
+    void addEdge(size_t from, size_t to)
+    {
+        std::lock_guard lock(mutex_);
+
+        std::vector<Edge>& edges = edges_[from];
+
+        if (std::any_of(edges.begin(), edges.end(), [to](const Edge& edge) { return edge.to == to; })) {
+            return;
+        }
+
+        // NOTE: Новое ребро from -> to замыкает цикл, если из to уже можно добраться до from.
+        std::vector<const Edge*> path;
+
+        if (findPath(to, from, path) && reported_.insert({ std::min(from, to), std::max(from, to) }).second) {
+            reportInversion(from, to, path);
+        }
+
+        edges.push_back({ to, describeThread(to) });
+    }
+
+    /**
+     * @brief Ищет путь в графе (поиском в глубину) и сохраняет его рёбра.
+     */
+    bool findPath(size_t from, size_t to, std::vector<const Edge*>& path) const
+    {
+        std::vector<bool> visited(labels_.size(), false);
+        return findPath(from, to, path, visited);
+    }
+
+    bool findPath(size_t from, size_t to, std::vector<const Edge*>& path, std::vector<bool>& visited) const
+    {
+        if (from == to) {
+            return true;
+        }
+
+        visited[from] = true;
+
+        for (const Edge& edge : edges_[from]) {
+            if (!visited[edge.to]) {
+                path.push_back(&edge);
+
+                if (findPath(edge.to, to, path, visited)) {
+                    return true;
+                }
+
+                path.pop_back();
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Описание текущего потока: какие мьютексы он удерживает и какой захватывает.
+     * @note Вызывается под мьютексом графа.
+     */
+    std::string describeThread(size_t acquiring) const
+    {
+        std::ostringstream out;
+        out << "thread " << std::this_thread::get_id() << " acquires \"" << labels_[acquiring] << "\" while holding:\n";
+
+        const std::vector<Held>& held = heldLocks();
+
+        for (size_t i = held.size(); i-- > 0;) {
+            out << "    #" << held.size() - 1 - i << " \"" << labels_[held[i].label] << "\"\n";
+        }
+
+        return out.str();
+    }
+
+    void reportInversion(size_t from, size_t to, const std::vector<const Edge*>& path) const
+    {
+        std::cerr << "=== Possible deadlock: lock order inversion \"" << labels_[from] << "\" -> \"" << labels_[to]
+                  << "\" ===\n" << describeThread(to)
+                  << "but the opposite order was recorded earlier:\n";
+
+        for (const Edge* edge : path) {
+            std::cerr << edge->witness;
+        }
+
+        std::cerr << std::flush;
+    }
+
+    void reportRelocking(size_t label)
+    {
+        std::lock_guard lock(mutex_);
+
+        if (!reported_.insert({ label, label }).second) {
+            return;
+        }
+
+        std::cerr << "=== Possible deadlock: recursive locking of non-recursive mutex \"" << labels_[label]
+                  << "\" ===\n" << describeThread(label) << std::flush;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> labels_;
+    std::vector<std::vector<Edge>> edges_;  // NOTE: Рёбра графа по классам, из которых они выходят.
+    std::set<std::pair<size_t, size_t>> reported_; // NOTE: О каждой проблеме сообщаем один раз.
+};
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @class DurationHistogram
+ * @brief Гистограмма длительностей с корзинами по степеням двойки наносекунд: [2^i, 2^(i+1)).
+ *
+ * Запись - одна инструкция подсчёта ведущих нулей и инкремент, поэтому годится для горячего пути.
+ * Процентили вычисляются с точностью до корзины (не хуже чем вдвое).
+ */
+class DurationHistogram final
+{
+public:
+    void record(std::chrono::nanoseconds duration) noexcept
+    {
+        const auto nanoseconds = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+
+        ++buckets_[bucketOf(nanoseconds)];
+        ++count_;
+        max_ = std::max(max_, nanoseconds);
+    }
+
+    void merge(const DurationHistogram& other) noexcept
+    {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            buckets_[i] += other.buckets_[i];
+        }
+
+        count_ += other.count_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t count() const noexcept
+    {
+        return count_;
+    }
+
+    std::chrono::nanoseconds max() const noexcept
+    {
+        return std::chrono::nanoseconds(max_);
+    }
+
+    /**
+     * @return верхняя граница корзины, в которую попадает указанный процент значений (но не больше максимума)
+     */
+    std::chrono::nanoseconds percentile(double percent) const noexcept
+    {
+        const auto rank = static_cast<uint64_t>(static_cast<double>(count_) * percent / 100.0 + 0.5);
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+
+            if (seen >= std::max<uint64_t>(rank, 1)) {
+                const uint64_t upper = (i + 1 < 64) ? (uint64_t(1) << (i + 1)) - 1 : UINT64_MAX;
+                return std::chrono::nanoseconds(std::min(upper, max_));
+            }
+        }
+
+        return max();
+    }
+
+private:
+    static constexpr size_t BUCKETS = 64;
+
+    static size_t bucketOf(uint64_t nanoseconds) noexcept
+    {
+        if (nanoseconds == 0) {
+            return 0;
+        }
+
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, nanoseconds);
+        return index;
+#else
+        return static_cast<size_t>(63 - __builtin_clzll(nanoseconds));
+#endif
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+};
+
+/**
+ * @class LockProfiler
+ * @brief Собирает статистику блокировок по меткам мьютексов и печатает сводку при завершении программы.
+ *
+ * Каждый поток копит счётчики в своей thread_local памяти (без блокировок и общих записей) и сдаёт их
+ * профилировщику лишь при завершении. Мьютексы с одинаковой меткой учитываются вместе.
+ * @note Сводка учитывает потоки, завершившиеся до её печати (включая главный поток при выходе из main()).
+ */
+class LockProfiler final
+{
+public:
+    /**
+     * @struct Statistics
+     * @brief Статистика одной метки в одном потоке.
+     */
+    struct Statistics
+    {
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0; // NOTE: Захваты, которым пришлось ждать освобождения мьютекса.
+        DurationHistogram wait;
+        DurationHistogram hold;
+
+        void merge(const Statistics& other) noexcept
+        {
+            acquisitions += other.acquisitions;
+            contended += other.contended;
+            wait.merge(other.wait);
+            hold.merge(other.hold);
+        }
+    };
+
+    static LockProfiler& instance()
+    {
+        static LockProfiler profiler;
+        return profiler;
+    }
+
+    LockProfiler(const LockProfiler& other) = delete;
+    LockProfiler& operator=(const LockProfiler& other) = delete;
+
+    ~LockProfiler()
+    {
+        report(std::cerr);
+    }
+
+    /**
+     * @return номер метки (у одинаковых меток - один номер)
+     */
+    size_t registerLabel(std::string_view label)
+    {
+        std::lock_guard lock(mutex_);
+
+        const auto it = std::find(labels_.begin(), labels_.end(), label);
+
+        if (it != labels_.end()) {
+            return static_cast<size_t>(it - labels_.begin());
+        }
+
+        labels_.emplace_back(label);
+        return labels_.size() - 1;
+    }
+
+    /**
+     * @brief Статистика метки в текущем потоке.
+     */
+    static Statistics& local(size_t label)
+    {
+        thread_local ThreadProfile profile;
+
+        if (label >= profile.labels.size()) {
+            profile.labels.resize(label + 1);
+        }
+
+        return profile.labels[label];
+    }
+
+    /**
+     * @brief Печатает сводку по меткам: итог и строки по потокам.
+     */
+    void report(std::ostream& out) const
+    {
+        std::lock_guard lock(mutex_);
+
+        if (threads_.empty()) {
+            return;
+        }
+
+        out << "Lock profile (times in us)\n" << std::left << std::setw(16) << "label" << std::setw(18) << "thread"
+            << std::right << std::setw(12) << "acquired" << std::setw(11) << "contended"
+            << std::setw(10) << "wait p50" << std::setw(10) << "wait p99" << std::setw(10) << "wait max"
+            << std::setw(10) << "hold p50" << std::setw(10) << "hold p99" << std::setw(10) << "hold max" << "\n";
+
+        for (size_t label = 0; label < labels_.size(); ++label) {
+            Statistics total;
+
+            for (const ThreadRecord& thread : threads_) {
+                if (label < thread.labels.size()) {
+                    total.merge(thread.labels[label]);
+                }
+            }
+
+            if (total.acquisitions == 0) {
+                continue;
+            }
+
+            print(out, labels_[label], "all", total);
+
+            for (const ThreadRecord& thread : threads_) {
+                if (label < thread.labels.size() && thread.labels[label].acquisitions > 0) {
+                    print(out, "", thread.name, thread.labels[label]);
+                }
+            }
+        }
+    }
+
+private:
+    /**
+     * @struct ThreadRecord
+     * @brief Статистика завершившегося потока.
+     */
+    struct ThreadRecord
+    {
+        std::string name;
+        std::vector<Statistics> labels;
+    };
+
+    /**
+     * @struct ThreadProfile
+     * @brief Статистика потока, которую он сдаёт профилировщику при завершении.
+     */
+    struct ThreadProfile
+    {
+        std::vector<Statistics> labels;
+
+        ~ThreadProfile()
+        {
+            std::ostringstream name;
+            name << std::this_thread::get_id();
+
+            LockProfiler::instance().collect({ name.str(), std::move(labels) });
+        }
+    };
+
+    LockProfiler() = default;
+
+    void collect(ThreadRecord&& record)
+    {
+        std::lock_guard lock(mutex_);
+        threads_.push_back(std::move(record));
+    }
+
+    static void print(std::ostream& out, std::string_view label, std::string_view thread, const Statistics& statistics)
+    {
+        const auto microseconds = [](std::chrono::nanoseconds duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        };
+
+        const double contended = 100.0 * static_cast<double>(statistics.contended)
+            / static_cast<double>(std::max<uint64_t>(statistics.acquisitions, 1));
+
+        out << std::left << std::setw(16) << label << std::setw(18) << thread << std::right
+            << std::setw(12) << statistics.acquisitions
+            << std::setw(10) << std::fixed << std::setprecision(1) << contended << "%"
+            << std::setprecision(2)
+            << std::setw(10) << microseconds(statistics.wait.percentile(50))
+            << std::setw(10) << microseconds(statistics.wait.percentile(99))
+            << std::setw(10) << microseconds(statistics.wait.max())
+            << std::setw(10) << microseconds(statistics.hold.percentile(50))
+            << std::setw(10) << microseconds(statistics.hold.percentile(99))
+            << std::setw(10) << microseconds(statistics.hold.max()) << "\n";
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> labels_;
+    std::vector<ThreadRecord> threads_;
+};
@@ -0,0 +1,505 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Epoch.h"
+
+/**
+ * @class SkipListMap
+ * @brief Потокобезопасный упорядоченный ассоциативный контейнер на основе списка с пропусками (skip list).
+ *
+ * Это "ленивый" список с пропусками (Herlihy, Lev, Luchangco, Shavit):
+ * - поиск и обход диапазона не захватывают блокировок и ничего не пишут в общую память;
+ * - вставка и удаление блокируют лишь соседние узлы, поэтому операции с разными ключами идут параллельно;
+ * - удаление сначала помечает узел, затем исключает его из списка, а память освобождается, когда его уже
+ *   не может читать ни один поток (см. EpochDomain).
+ * Значения не изменяются после вставки: чтобы заменить значение, удалите элемент и вставьте заново.
+ *
+ * @note Обход диапазона видит каждый элемент, который был в контейнере всё время обхода, но может не увидеть
+ *       элементы, вставленные или удалённые во время него.
+ */
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+class SkipListMap
+{
+public:
+    SkipListMap() = default;
+
+    SkipListMap(const SkipListMap& other) = delete;
+    SkipListMap& operator=(const SkipListMap& other) = delete;
+
+    // WARNING: К моменту удаления контейнера ни один поток не должен с ним работать.
+    ~SkipListMap()
+    {
+        for (Node* node = head_.next[0].load(std::memory_order_relaxed); node != nullptr;) {
+            Node* const next = node->next[0].load(std::memory_order_relaxed);
+            destroyNode(node);
+            node = next;
+        }
+
+        for (const RetireList& list : retired_) {
+            for (const Retired& retired : list.nodes) {
+                destroyNode(retired.node);
+            }
+        }
+    }
+
+    /**
+     * @brief Вставляет элемент, если элемента с таким ключом ещё нет.
+     * @return true, если элемент вставлен
+     */
+    bool insert(const Key& key, const Value& value)
+    {
+        EpochGuard guard;
+
+        const size_t levels = randomLevels();
+        Tower* predecessors[MAX_LEVELS];
+        Node* successors[MAX_LEVELS];
+
+        while (true) {
+            const int found = find(key, predecessors, successors);
+
+            if (found >= 0) {
+                const Node* const node = successors[found];
+
+                // NOTE: Ключ уже есть. Если его как раз удаляют, повторяем попытку, а если вставляют - дожидаемся
+                // окончания вставки, чтобы сразу после возврата false элемент был виден.
+                if (!node->marked.load(std::memory_order_acquire)) {
+                    while (!node->linked.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+
+                    return false;
+                }
+
+                continue;
+            }
+
+            // NOTE: Блокируем предшественников снизу вверх (справа налево по ключам), как и удаление, - так потоки
+            // захватывают узлы в одном порядке и не блокируют друг друга.
+            LockedTowers locks;
+            bool valid = true;
+
+            for (size_t level = 0; valid && level < levels; ++level) {
+                Tower* const predecessor = predecessors[level];
+                Node* const successor = successors[level];
+
+                locks.lock(predecessor);
+
+                valid = !predecessor->marked.load(std::memory_order_acquire)
+                    && (successor == nullptr || !successor->marked.load(std::memory_order_acquire))
+                    && predecessor->next[level].load(std::memory_order_acquire) == successor;
+            }
+
+            // NOTE: Пока мы искали, соседи изменились - ищем заново.
+            if (!valid) {
+                continue;
+            }
+
+            Node* const node = createNode(key, value, levels);
+
+            for (size_t level = 0; level < levels; ++level) {
+                node->next[level].store(successors[level], std::memory_order_relaxed);
+            }
+
+            for (size_t level = 0; level < levels; ++level) {
+                predecessors[level]->next[level].store(node, std::memory_order_release);
+            }
+
+            node->linked.store(true, std::memory_order_release);
+            size_.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+    }
+
+    /**
+     * @brief Удаляет элемент с указанным ключом.
+     * @return true, если элемент был удалён этим вызовом
+     */
+    bool erase(const Key& key)
+    {
+        EpochGuard guard;
+
+        Tower* predecessors[MAX_LEVELS];
+        Node* successors[MAX_LEVELS];
+        Node* victim = nullptr;
+        std::unique_lock<std::mutex> victimLock;
+
+        while (true) {
+            const int found = find(key, predecessors, successors);
+
+            if (!victimLock) {
+                if (found < 0) {
+                    return false;
+                }
+
+                victim = successors[found];
+
+                // NOTE: Удалять можно лишь полностью вставленный узел, найденный на его верхнем уровне.
+                if (!victim->linked.load(std::memory_order_acquire) || static_cast<size_t>(found) + 1 != victim->levels
+                    || victim->marked.load(std::memory_order_acquire)) {
+                    return false;
+                }
+
+                victimLock = std::unique_lock(victim->mutex);
+
+                // NOTE: Другой поток успел удалить элемент раньше.
+                if (victim->marked.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+
+                // NOTE: С этого момента элемент считается удалённым: поиск его не найдёт.
+                victim->marked.store(true, std::memory_order_release);
+            }
+
+            LockedTowers locks;
+            bool valid = true;
+
+            for (size_t level = 0; valid && level < victim->levels; ++level) {
+                Tower* const predecessor = predecessors[level];
+
+                locks.lock(predecessor);
+
+                valid = !predecessor->marked.load(std::memory_order_acquire)
+                    && predecessor->next[level].load(std::memory_order_acquire) == victim;
+            }
+
+            if (!valid) {
+                continue;
+            }
+
+            for (size_t level = victim->levels; level-- > 0;) {
+                predecessors[level]->next[level].store(victim->next[level].load(std::memory_order_relaxed),
+                                                       std::memory_order_release);
+            }
+
+            victimLock.unlock();
+            size_.fetch_sub(1, std::memory_order_relaxed);
+
+            retire(victim);
+            return true;
+        }
+    }
+
+    /**
+     * @return копия значения, если элемент с таким ключом есть, иначе std::nullopt
+     */
+    std::optional<Value> find(const Key& key) const
+    {
+        EpochGuard guard;
+
+        const Node* const node = findNode(key);
+
+        return (node != nullptr && node->linked.load(std::memory_order_acquire)
+                && !node->marked.load(std::memory_order_acquire))
+            ? std::make_optional(node->value)
+            : std::nullopt;
+    }
+
+    bool contains(const Key& key) const
+    {
+        EpochGuard guard;
+
+        const Node* const node = findNode(key);
+
+        return node != nullptr && node->linked.load(std::memory_order_acquire)
+            && !node->marked.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Обходит элементы с ключами из [from, to) по возрастанию ключей.
+     * @param visit вызывается для каждого элемента: visit(key, value)
+     * @warning Обработчик не должен обращаться к этому же контейнеру.
+     */
+    template<typename Visitor>
+    void scan(const Key& from, const Key& to, Visitor&& visit) const
+    {
+        EpochGuard guard;
+
+        const Tower* predecessor = &head_;
+        const Node* node = nullptr;
+
+        for (size_t level = MAX_LEVELS; level-- > 0;) {
+            node = predecessor->next[level].load(std::memory_order_acquire);
+
+            while (node != nullptr && compare_(node->key, from)) {
+                predecessor = node;
+                node = node->next[level].load(std::memory_order_acquire);
+            }
+        }
+
+        // NOTE: Обход начинаем с узла, на котором остановился спуск, а не перечитываем ссылку предшественника:
+        // за это время перед from мог быть вставлен узел с меньшим ключом.
+        for (; node != nullptr && compare_(node->key, to); node = node->next[0].load(std::memory_order_acquire)) {
+            if (node->linked.load(std::memory_order_acquire) && !node->marked.load(std::memory_order_acquire)) {
+                visit(node->key, node->value);
+            }
+        }
+    }
+
+    /**
+     * @brief Число элементов. При одновременных вставках и удалениях - приблизительное.
+     */
+    size_t size() const noexcept
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+private:
+    // NOTE: 2^24 элементов - с вероятностью 1/2 узел поднимается на уровень выше.
+    static constexpr size_t MAX_LEVELS = 24;
+
+    // NOTE: Удаляем убранные узлы пачками, чтобы не обходить ячейки эпох при каждом удалении.
+    static constexpr size_t RECLAIM_BATCH = 64;
+
+    // NOTE: Число списков убранных узлов: потоки, одновременно удаляющие элементы, обычно пишут в разные списки.
+    static constexpr size_t RETIRE_SHARDS = 16;
+
+    struct Node;
+
+    /**
+     * @struct Tower
+     * @brief Ссылки узла на следующие узлы на каждом из его уровней, блокировка и флаги состояния узла.
+     */
+    struct Tower
+    {
+        Tower(size_t levels, std::atomic<Node*>* next)
+            : levels(levels)
+            , next(next)
+        {}
+
+        const size_t levels;
+        std::atomic<Node*>* const next;
+
+        std::mutex mutex;
+        std::atomic<bool> marked = false; // NOTE: Узел удаляется.
+        std::atomic<bool> linked = false; // NOTE: Узел вставлен на всех своих уровнях.
+    };
+
+    /**
+     * @struct Node
+     * @brief Узел с элементом. Ссылки на следующие узлы лежат в той же области памяти сразу за узлом:
+     *        при поиске ключ и ссылки читаются из одних строк кэша, без перехода по отдельному указателю.
+     */
+    struct Node : Tower
+    {
+        Node(const Key& key, const Value& value, size_t levels)
+            : Tower(levels, reinterpret_cast<std::atomic<Node*>*>(reinterpret_cast<char*>(this) + sizeof(Node)))
+            , key(key)
+            , value(value)
+        {
+            for (size_t level = 0; level < levels; ++level) {
+                new (this->next + level) std::atomic<Node*>(nullptr);
+            }
+        }
+
+        const Key key;
+        const Value value;
+    };
+
+    /**
+     * @class LockedTowers
+     * @brief Заблокированные предшественники. Один узел может быть предшественником на нескольких уровнях подряд,
+     *        но блокируется один раз. Блокировки снимаются при выходе из области видимости.
+     */
+    class LockedTowers final
+    {
+    public:
+        LockedTowers() = default;
+
+        LockedTowers(const LockedTowers& other) = delete;
+        LockedTowers& operator=(const LockedTowers& other) = delete;
+
+        ~LockedTowers()
+        {
+            for (size_t i = 0; i < count_; ++i) {
+                towers_[i]->mutex.unlock();
+            }
+        }
+
+        void lock(Tower* tower)
+        {
+            if (count_ > 0 && towers_[count_ - 1] == tower) {
+                return;
+            }
+
+            tower->mutex.lock();
+            towers_[count_++] = tower;
+        }
+
+    private:
+        Tower* towers_[MAX_LEVELS] = {};
+        size_t count_ = 0;
+    };
+
+    /**
+     * @struct Retired
+     * @brief Исключённый из списка узел, который удаляется после эпохи epoch.
+     */
+    struct Retired
+    {
+        Node* node;
+        uint64_t epoch;
+    };
+
+    /**
+     * @struct RetireList
+     * @brief Список убранных узлов под своим мьютексом, в отдельной строке кэша.
+     */
+    struct alignas(64) RetireList
+    {
+        std::mutex mutex;
+        std::vector<Retired> nodes;
+        size_t reclaimAt = RECLAIM_BATCH; // NOTE: Размер списка, при котором пора удалять узлы.
+    };
+
+    /**
+     * @brief Ищет ключ, запоминая на каждом уровне последний узел перед ним и первый узел не меньше него.
+     * @return верхний уровень, на котором найден узел с ключом, или -1
+     */
+    int find(const Key& key, Tower** predecessors, Node** successors)
+    {
+        int found = -1;
+        Tower* predecessor = &head_;
+
+        for (size_t level = MAX_LEVELS; level-- > 0;) {
+            Node* node = predecessor->next[level].load(std::memory_order_acquire);
+
+            while (node != nullptr && compare_(node->key, key)) {
+                predecessor = node;
+                node = node->next[level].load(std::memory_order_acquire);
+            }
+
+            if (found < 0 && node != nullptr && !compare_(key, node->key)) {
+                found = static_cast<int>(level);
+            }
+
+            predecessors[level] = predecessor;
+            successors[level] = node;
+        }
+
+        return found;
+    }
+
+    const Node* findNode(const Key& key) const
+    {
+        const Tower* predecessor = &head_;
+
+        for (size_t level = MAX_LEVELS; level-- > 0;) {
+            const Node* node = predecessor->next[level].load(std::memory_order_acquire);
+
+            while (node != nullptr && compare_(node->key, key)) {
+                predecessor = node;
+                node = node->next[level].load(std::memory_order_acquire);
+            }
+
+            if (node != nullptr && !compare_(key, node->key)) {
+                return node;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static Node* createNode(const Key& key, const Value& value, size_t levels)
+    {
+        static_assert(sizeof(Node) % alignof(std::atomic<Node*>) == 0);
+
+        void* const memory = ::operator new(sizeof(Node) + levels * sizeof(std::atomic<Node*>));
+
+        try {
+            return new (memory) Node(key, value, levels);
+        } catch (...) {
+            ::operator delete(memory);
+            throw;
+        }
+    }
+
+    static void destroyNode(Node* node) noexcept
+    {
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    /**
+     * @brief Случайная высота нового узла: уровень k достаётся с вероятностью 1/2^k.
+     */
+    static size_t randomLevels() noexcept
+    {
+        thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+        // NOTE: xorshift64.
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        size_t levels = 1;
+
+        for (uint64_t bits = state; (bits & 1) != 0 && levels < MAX_LEVELS; bits >>= 1) {
+            ++levels;
+        }
+
+        return levels;
+    }
+
+    /**
+     * @brief Список убранных узлов текущего потока. Потоки получают списки по кругу.
+     */
+    static size_t retireShard() noexcept
+    {
+        static std::atomic<size_t> nextShard = 0;
+        thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % RETIRE_SHARDS;
+
+        return shard;
+    }
+
+    void retire(Node* node)
+    {
+        EpochDomain& domain = EpochDomain::instance();
+        RetireList& list = retired_[retireShard()];
+        std::lock_guard lock(list.mutex);
+
+        list.nodes.push_back({ node, domain.retire() });
+
+        if (list.nodes.size() < list.reclaimAt) {
+            return;
+        }
+
+        const uint64_t safeEpoch = domain.safeEpoch();
+
+        const auto it = std::partition(list.nodes.begin(), list.nodes.end(), [safeEpoch](const Retired& retired) {
+            return retired.epoch >= safeEpoch;
+        });
+
+        std::for_each(it, list.nodes.end(), [](const Retired& retired) { destroyNode(retired.node); });
+        list.nodes.erase(it, list.nodes.end());
+
+        // NOTE: Если долгий читатель не дал удалить большую часть узлов, следующую попытку откладываем, пока список
+        // не вырастет вдвое: иначе каждое удаление обходило бы весь список.
+        list.reclaimAt = std::max(RECLAIM_BATCH, 2 * list.nodes.size());
+    }
+
+private:
+    std::atomic<Node*> headNext_[MAX_LEVELS] = {};
+    Tower head_{ MAX_LEVELS, headNext_ };
+    Compare compare_;
+    std::atomic<size_t> size_ = 0;
+
+    RetireList retired_[RETIRE_SHARDS];
+};
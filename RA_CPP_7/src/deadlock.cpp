@@ -1,44 +1,20 @@
 #include <chrono>
 #include <iostream>
 #include <mutex>
+#include <string_view>
 #include <thread>
 
+#include "DebugMutex.h"
+
 #define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
 
 using namespace std::chrono_literals;
 
-/**
- * @class DebugMutex
- * @brief Отладочная обёртка над мьютексом. Выводит в stdout информации о блокировках.
- */
-template<typename Mutex>
-class DebugMutex final : private Mutex
-{
-public:
-    explicit DebugMutex(std::string_view label)
-        : label_(label)
-    {}
-
-    void lock()
-    {
-        Mutex::lock();
-        std::cout << label_ << " locked from " << std::this_thread::get_id() << std::endl;
-    }
-
-    void unlock()
-    {
-        Mutex::unlock();
-        std::cout << label_ << " unlocked from " << std::this_thread::get_id() << std::endl;
-    }
-
-private:
-    std::string label_;
-};
-
 /**
  * @class BTree
  * @brief Бинарное дерево поиска.
  * @warning Балансировки нет. Не используйте в реальном коде.
+ * @note Потокобезопасный упорядоченный контейнер без общего мьютекса - SkipListMap (SkipListMap.h).
  * @tparam Сompare функция сравнения ключей
  */
 template<typename T, typename Compare = std::less<T>>
@@ -55,7 +31,8 @@ struct BTree final
     void insert(T&& value)
     {
         // NOTE: Защищаем вставку в дерево в мьютексом.
-        static DebugMutex<std::mutex> mutex("InsertMutex");
+        // LockOrderPolicy сообщит о повторном захвате мьютекса ещё до того, как поток заблокирует сам себя.
+        static DebugMutex<std::mutex, LockOrderPolicy> mutex("InsertMutex");
         std::lock_guard lock(mutex);
 
         std::this_thread::sleep_for(1ms);
@@ -107,8 +84,8 @@ struct ThreadSafeUser : public User
         , passwordMutex("PasswordMutex")
     {}
 
-    DebugMutex<std::mutex> loginMutex;
-    DebugMutex<std::mutex> passwordMutex;
+    DebugMutex<std::mutex, LockOrderPolicy> loginMutex;
+    DebugMutex<std::mutex, LockOrderPolicy> passwordMutex;
 };
 
 namespace
@@ -127,10 +104,9 @@ namespace
     {
         return out << "User(" << user.login() << ", " << user.password() << ")";
     }
-}
 
-int main()
-{
+    // NOTE: Рекурсивная вставка повторно захватывает мьютекс, которым уже владеет поток, - поток блокирует сам себя.
+    void insertDeadlock()
     {
         BTree tree(42);
 
@@ -146,6 +122,7 @@ int main()
     }
 
     // NOTE: Захватываем мьютексы в разном порядке и получаем взаимную блокировку.
+    void lockOrderDeadlock()
     {
         ThreadSafeUser user;
 
@@ -174,6 +151,22 @@ int main()
 
         std::cout << user << "\n";
     }
+}
+
+// NOTE: Обе демонстрации зависают во взаимной блокировке, поэтому запускается одна, выбранная аргументом:
+// LockOrderPolicy сообщит о проблеме в stderr ещё до зависания.
+int main(int argc, char** argv)
+{
+    const std::string_view demo = (argc == 2) ? argv[1] : "";
+
+    if (demo == "insert") {
+        insertDeadlock();
+    } else if (demo == "lock-order") {
+        lockOrderDeadlock();
+    } else {
+        std::cerr << "Usage: " << argv[0] << " insert|lock-order" << "\n";
+        return 1;
+    }
 
     return 0;
 }
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DebugMutex.h"
+
+// NOTE: Профилирование блокировок: вместо вывода каждого захвата DebugMutex с ProfilePolicy копит статистику,
+// и при завершении программы в stderr печатается сводка - сколько раз мьютекс захватывали, как часто
+// приходилось ждать, сколько длилось ожидание и удержание.
+
+namespace
+{
+    /**
+     * @class Bank
+     * @brief Счета и журнал операций, каждый под своим мьютексом.
+     */
+    class Bank final
+    {
+    public:
+        explicit Bank(size_t accounts)
+            : accounts_(accounts, 100)
+            , accountsMutex_("AccountsMutex")
+            , journalMutex_("JournalMutex")
+        {}
+
+        void transfer(size_t from, size_t to, int amount)
+        {
+            // NOTE: Короткая, но частая критическая секция.
+            {
+                std::lock_guard lock(accountsMutex_);
+                accounts_[from] -= amount;
+                accounts_[to] += amount;
+            }
+
+            // NOTE: Запись в журнал дольше (выделение памяти и форматирование внутри критической секции).
+            if (from % 16 == 0) {
+                std::lock_guard lock(journalMutex_);
+                journal_.push_back(std::to_string(from) + " -> " + std::to_string(to) + ": " + std::to_string(amount));
+            }
+        }
+
+        int total()
+        {
+            std::lock_guard lock(accountsMutex_);
+
+            int sum = 0;
+
+            for (const int balance : accounts_) {
+                sum += balance;
+            }
+
+            return sum;
+        }
+
+    private:
+        std::vector<int> accounts_;
+        std::vector<std::string> journal_;
+
+        DebugMutex<std::mutex, ProfilePolicy> accountsMutex_;
+        DebugMutex<std::mutex, ProfilePolicy> journalMutex_;
+    };
+}
+
+int main()
+{
+    constexpr size_t ACCOUNTS = 64;
+    constexpr size_t TRANSFERS = 100000;
+
+    Bank bank(ACCOUNTS);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([i, &bank] {
+            for (size_t transfer = 0; transfer < TRANSFERS; ++transfer) {
+                bank.transfer((transfer + i) % ACCOUNTS, (transfer * 7 + i) % ACCOUNTS, 1);
+            }
+        });
+    }
+
+    std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+
+    std::cout << "Total: " << bank.total() << "\n";
+
+    return 0;
+}
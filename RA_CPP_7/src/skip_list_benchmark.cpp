@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "CommandLine.h"
+#include "SkipListMap.h"
+
+// NOTE: Замеры пропускной способности упорядоченных контейнеров (операций в секунду) при разном числе потоков:
+// SkipListMap против std::map под одним мьютексом. Операции - поиск, вставка, удаление и обход диапазона
+// со случайными ключами; доли записей и обходов задаются параметрами.
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Параметры замеров.
+     */
+    struct Options final
+    {
+        size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1); // NOTE: Наибольшее число потоков.
+        size_t operations = 1000000; // NOTE: Число операций одного потока.
+        size_t writes = 20;          // NOTE: Доля записей (в процентах), поровну вставок и удалений.
+        size_t scans = 1;            // NOTE: Доля обходов диапазона (в процентах).
+        size_t range = 100;          // NOTE: Длина обходимого диапазона ключей.
+        size_t keys = 100000;
+    };
+
+    // NOTE: Ключи и границы обходов (ключ + длина диапазона) - int: ограничиваем слагаемые, чтобы сумма не переполнилась.
+    constexpr size_t MAX_KEYS = std::numeric_limits<int>::max() / 2;
+
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view key = argv[i];
+
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            const std::string_view value = argv[++i];
+            bool valid = false;
+
+            if (key == "--threads") {
+                valid = parseNumber(value, options.threads);
+            } else if (key == "--operations") {
+                valid = parseNumber(value, options.operations);
+            } else if (key == "--writes") {
+                valid = parseNumber(value, options.writes, 0, 100);
+            } else if (key == "--scans") {
+                valid = parseNumber(value, options.scans, 0, 100);
+            } else if (key == "--range") {
+                valid = parseNumber(value, options.range, 1, MAX_KEYS);
+            } else if (key == "--keys") {
+                valid = parseNumber(value, options.keys, 1, MAX_KEYS);
+            }
+
+            if (!valid) {
+                return std::nullopt;
+            }
+        }
+
+        if (options.writes + options.scans > 100) {
+            return std::nullopt;
+        }
+
+        return options;
+    }
+
+    /**
+     * @class LockedMap
+     * @brief std::map под одним мьютексом с тем же интерфейсом, что и у SkipListMap.
+     */
+    template<typename Key, typename Value>
+    class LockedMap final
+    {
+    public:
+        bool insert(const Key& key, const Value& value)
+        {
+            std::lock_guard lock(mutex_);
+            return map_.emplace(key, value).second;
+        }
+
+        bool erase(const Key& key)
+        {
+            std::lock_guard lock(mutex_);
+            return map_.erase(key) > 0;
+        }
+
+        std::optional<Value> find(const Key& key) const
+        {
+            std::lock_guard lock(mutex_);
+
+            const auto it = map_.find(key);
+            return (it != map_.end()) ? std::make_optional(it->second) : std::nullopt;
+        }
+
+        template<typename Visitor>
+        void scan(const Key& from, const Key& to, Visitor&& visit) const
+        {
+            std::lock_guard lock(mutex_);
+
+            for (auto it = map_.lower_bound(from); it != map_.end() && it->first < to; ++it) {
+                visit(it->first, it->second);
+            }
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::map<Key, Value> map_;
+    };
+
+    /**
+     * @class Random
+     * @brief Быстрый генератор псевдослучайных чисел (xorshift64): у каждого потока свой.
+     */
+    class Random final
+    {
+    public:
+        explicit Random(uint64_t seed) noexcept
+            : state_(seed * 0x9E3779B97F4A7C15ull + 1)
+        {}
+
+        uint64_t operator()() noexcept
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    /**
+     * @struct Result
+     * @brief Итоги одного замера.
+     */
+    struct Result
+    {
+        double operationsPerSecond = 0;
+        bool consistent = true; // NOTE: Каждый обход вернул лишь ключи из своего диапазона, по возрастанию.
+    };
+
+    /**
+     * @brief Выполняет операции с контейнером в указанном числе потоков.
+     */
+    template<typename Map>
+    Result measure(Map& map, const Options& options, size_t threadCount)
+    {
+        std::atomic<bool> start = false;
+        std::atomic<bool> consistent = true;
+        std::atomic<uint64_t> checksum = 0;
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&, i] {
+                Random random(i + 1);
+                uint64_t sum = 0;
+                bool ordered = true;
+
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                for (size_t operation = 0; operation < options.operations; ++operation) {
+                    const uint64_t number = random();
+                    const uint64_t kind = number % 100;
+                    const auto key = static_cast<int>((number >> 8) % options.keys);
+
+                    if (kind < options.writes) {
+                        sum += (kind % 2 == 0) ? map.insert(key, key) : map.erase(key);
+                    } else if (kind < options.writes + options.scans) {
+                        const auto to = static_cast<int>(key + options.range);
+                        int previous = key - 1;
+
+                        // NOTE: Проверяем границы и порядок: обходы идут одновременно со вставками и удалениями.
+                        map.scan(key, to, [&](int found, int value) {
+                            ordered = ordered && found > previous && found < to && value == found;
+                            previous = found;
+                            sum += value;
+                        });
+                    } else {
+                        sum += map.find(key).has_value();
+                    }
+                }
+
+                // NOTE: Результаты складываем, чтобы компилятор не выбросил операции.
+                checksum.fetch_add(sum, std::memory_order_relaxed);
+
+                if (!ordered) {
+                    consistent.store(false, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        start.store(true, std::memory_order_release);
+
+        std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        return { static_cast<double>(options.operations * threadCount) / seconds, consistent.load() };
+    }
+
+    /**
+     * @brief Заполняет половину ключей, чтобы поиски находили как существующие, так и отсутствующие ключи.
+     */
+    template<typename Map>
+    void fill(Map& map, const Options& options)
+    {
+        for (size_t key = 0; key < options.keys; key += 2) {
+            map.insert(static_cast<int>(key), static_cast<int>(key));
+        }
+    }
+
+    template<typename Map>
+    bool run(std::string_view name, const Options& options, size_t threads)
+    {
+        Map map;
+        fill(map, options);
+
+        const Result result = measure(map, options, threads);
+
+        std::cout << std::setw(10) << threads << std::setw(16) << name
+                  << std::fixed << std::setprecision(0) << result.operationsPerSecond
+                  << (result.consistent ? "" : " (scan out of range!)") << "\n";
+
+        return result.consistent;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--threads <max>] [--operations <per thread>] [--writes <percent>] [--scans <percent>]"
+                  << " [--range <keys>] [--keys <count>]\n";
+        return 1;
+    }
+
+    std::cout << "Writes: " << options->writes << "%, scans: " << options->scans << "% of " << options->range
+              << " keys, keys: " << options->keys << ", operations per thread: " << options->operations << "\n"
+              << std::left << std::setw(10) << "threads" << std::setw(16) << "map" << "ops/s" << "\n";
+
+    // NOTE: Степени двойки и ровно указанное число потоков, даже если оно не степень двойки.
+    std::vector<size_t> threadCounts;
+
+    for (size_t threads = 1; threads < options->threads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+
+    threadCounts.push_back(options->threads);
+
+    bool consistent = true;
+
+    for (const size_t threads : threadCounts) {
+        consistent = run<LockedMap<int, int>>("std::map+mutex", *options, threads) && consistent;
+        consistent = run<SkipListMap<int, int>>("skip list", *options, threads) && consistent;
+    }
+
+    return consistent ? 0 : 1;
+}
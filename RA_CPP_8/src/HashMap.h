@@ -0,0 +1,1245 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASH_MAP_WITH_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// NOTE: Хэш-таблица с открытой адресацией в стиле SwissTable (Abseil flat_hash_map). Элементы лежат прямо в массиве
+// ячеек, а для каждой ячейки хранится управляющий байт: пусто, удалено или 7 младших бит хэша ключа. Поиск сравнивает
+// сразу группу из 16 управляющих байтов (одной инструкцией SSE2) и сравнивает ключи лишь у ячеек с совпавшими битами
+// хэша, поэтому почти не ходит по указателям и редко промахивается мимо кэша.
+
+namespace detail
+{
+    inline uint32_t countTrailingZeros(uint64_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanForward64(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    inline uint32_t countLeadingZeros(uint64_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return 63 - static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+    }
+
+    /**
+     * @class BitMask
+     * @brief Набор ячеек группы, подошедших под условие: по Shift битов на ячейку, младшие биты - первые ячейки.
+     */
+    template<uint32_t Width, uint32_t Shift>
+    class BitMask final
+    {
+    public:
+        explicit BitMask(uint64_t mask) noexcept
+            : mask_(mask)
+        {}
+
+        explicit operator bool() const noexcept
+        {
+            return mask_ != 0;
+        }
+
+        /**
+         * @brief Номер первой подошедшей ячейки.
+         */
+        uint32_t lowest() const noexcept
+        {
+            return countTrailingZeros(mask_) >> Shift;
+        }
+
+        /**
+         * @brief Убирает первую подошедшую ячейку из набора.
+         */
+        void dropLowest() noexcept
+        {
+            mask_ &= mask_ - 1;
+        }
+
+        /**
+         * @brief Число неподошедших ячеек в начале группы.
+         */
+        uint32_t trailingZeros() const noexcept
+        {
+            return countTrailingZeros(mask_) >> Shift;
+        }
+
+        /**
+         * @brief Число неподошедших ячеек в конце группы.
+         */
+        uint32_t leadingZeros() const noexcept
+        {
+            constexpr uint32_t UNUSED_BITS = 64 - (Width << Shift);
+            return (countLeadingZeros(mask_) - UNUSED_BITS) >> Shift;
+        }
+
+    private:
+        uint64_t mask_;
+    };
+
+    // NOTE: Управляющие байты: пустая и удалённая ячейки отрицательны, занятая хранит 7 бит хэша (0..127).
+    enum Control : int8_t
+    {
+        EMPTY = -128,
+        DELETED = -2
+    };
+
+#ifdef HASH_MAP_WITH_SSE2
+    /**
+     * @class Group
+     * @brief Группа из 16 управляющих байтов, которые проверяются одной инструкцией SSE2.
+     */
+    class Group final
+    {
+    public:
+        static constexpr size_t WIDTH = 16;
+
+        using Mask = BitMask<WIDTH, 0>;
+
+        explicit Group(const int8_t* control) noexcept
+            : control_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+        {}
+
+        /**
+         * @brief Ячейки, в которых лежат элементы с указанными битами хэша.
+         */
+        Mask match(int8_t hash) const noexcept
+        {
+            return Mask(maskOf(_mm_cmpeq_epi8(_mm_set1_epi8(hash), control_)));
+        }
+
+        Mask matchEmpty() const noexcept
+        {
+            return match(EMPTY);
+        }
+
+        /**
+         * @brief Свободные ячейки: пустые и удалённые (у них установлен старший бит).
+         */
+        Mask matchEmptyOrDeleted() const noexcept
+        {
+            return Mask(maskOf(control_));
+        }
+
+    private:
+        static uint64_t maskOf(__m128i bytes) noexcept
+        {
+            return static_cast<uint16_t>(_mm_movemask_epi8(bytes));
+        }
+
+    private:
+        __m128i control_;
+    };
+#else
+    /**
+     * @class Group
+     * @brief Группа из 8 управляющих байтов, которые проверяются арифметикой над 64-битным словом (без SIMD).
+     */
+    class Group final
+    {
+    public:
+        static constexpr size_t WIDTH = 8;
+
+        using Mask = BitMask<WIDTH, 3>;
+
+        explicit Group(const int8_t* control) noexcept
+        {
+            std::memcpy(&control_, control, sizeof(control_));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            control_ = __builtin_bswap64(control_); // NOTE: Первая ячейка группы - в младшем байте.
+#endif
+        }
+
+        /**
+         * @brief Ячейки, в которых лежат элементы с указанными битами хэша.
+         * @note Изредка даёт ложные совпадения (их отсекает сравнение ключей), но не пропускает настоящие.
+         */
+        Mask match(int8_t hash) const noexcept
+        {
+            const uint64_t bytes = control_ ^ (LSBS * static_cast<uint8_t>(hash));
+            return Mask((bytes - LSBS) & ~bytes & MSBS);
+        }
+
+        // NOTE: Из отрицательных байтов только у пустого (0b10000000) сброшен бит 1.
+        Mask matchEmpty() const noexcept
+        {
+            return Mask(control_ & ~(control_ << 6) & MSBS);
+        }
+
+        Mask matchEmptyOrDeleted() const noexcept
+        {
+            return Mask(control_ & MSBS);
+        }
+
+    private:
+        static constexpr uint64_t LSBS = 0x0101010101010101ull;
+        static constexpr uint64_t MSBS = 0x8080808080808080ull;
+
+    private:
+        uint64_t control_ = 0;
+    };
+#endif
+
+    /**
+     * @brief Управляющие байты таблицы без ячеек: поиск в ней сразу находит пустую ячейку, не выделяя памяти.
+     */
+    inline const int8_t* emptyGroup() noexcept
+    {
+        alignas(16) static const int8_t group[Group::WIDTH] = {
+            EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+#ifdef HASH_MAP_WITH_SSE2
+            EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY
+#endif
+        };
+
+        return group;
+    }
+
+    /**
+     * @brief Перемешивает биты хэша: std::hash для целых чисел возвращает само число.
+     */
+    inline uint64_t mix(uint64_t hash) noexcept
+    {
+        // NOTE: Финальное перемешивание MurmurHash3.
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /**
+     * @brief Совпадает ли размещение в памяти std::pair<const Key, T> и std::pair<Key, T>.
+     */
+    template<typename Key, typename T>
+    constexpr bool isLayoutCompatible() noexcept
+    {
+        using Value = std::pair<const Key, T>;
+        using MutableValue = std::pair<Key, T>;
+
+        if constexpr (std::is_standard_layout_v<Value> && std::is_standard_layout_v<MutableValue>) {
+            return sizeof(Value) == sizeof(MutableValue) && alignof(Value) == alignof(MutableValue)
+                && offsetof(Value, first) == offsetof(MutableValue, first)
+                && offsetof(Value, second) == offsetof(MutableValue, second);
+        } else {
+            return false;
+        }
+    }
+}
+
+/**
+ * @class HashMap
+ * @brief Ассоциативный контейнер с интерфейсом std::unordered_map на основе хэш-таблицы с открытой адресацией.
+ *
+ * В отличие от std::unordered_map, элементы хранятся в самой таблице, а не в отдельных узлах, поэтому
+ * вставка (при рехэшировании) делает недействительными все итераторы, указатели и ссылки на элементы.
+ * Удаление делает недействительными лишь итераторы на удалённые элементы.
+ * Нет интерфейса корзин (bucket(), bucket_size() и т.п.): корзин как таковых нет.
+ * @note Контейнер не потокобезопасен, как и стандартные контейнеры.
+ */
+template<typename Key,
+         typename T,
+         typename Hash = std::hash<Key>,
+         typename KeyEqual = std::equal_to<Key>,
+         typename Allocator = std::allocator<std::pair<const Key, T>>>
+class HashMap
+{
+    using Group = detail::Group;
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+    using ControlAllocator = typename AllocatorTraits::template rebind_alloc<int8_t>;
+    using ControlAllocatorTraits = std::allocator_traits<ControlAllocator>;
+
+    union Slot;
+    using SlotAllocator = typename AllocatorTraits::template rebind_alloc<Slot>;
+    using SlotAllocatorTraits = std::allocator_traits<SlotAllocator>;
+
+    template<bool Const>
+    class Iterator;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AllocatorTraits::pointer;
+    using const_pointer = typename AllocatorTraits::const_pointer;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    HashMap()
+        : HashMap(0)
+    {}
+
+    explicit HashMap(size_type bucketCount,
+                     const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual(),
+                     const Allocator& allocator = Allocator())
+        : hash_(hash)
+        , equal_(equal)
+        , allocator_(allocator)
+    {
+        if (bucketCount > 0) {
+            resize(capacityFor(bucketCount));
+        }
+    }
+
+    explicit HashMap(const Allocator& allocator)
+        : HashMap(0, Hash(), KeyEqual(), allocator)
+    {}
+
+    template<typename InputIterator>
+    HashMap(InputIterator first,
+            InputIterator last,
+            size_type bucketCount = 0,
+            const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& allocator = Allocator())
+        : HashMap(bucketCount, hash, equal, allocator)
+    {
+        insert(first, last);
+    }
+
+    HashMap(std::initializer_list<value_type> values,
+            size_type bucketCount = 0,
+            const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& allocator = Allocator())
+        : HashMap(values.begin(), values.end(), bucketCount, hash, equal, allocator)
+    {}
+
+    HashMap(const HashMap& other)
+        : HashMap(other, AllocatorTraits::select_on_container_copy_construction(other.allocator_))
+    {}
+
+    HashMap(const HashMap& other, const Allocator& allocator)
+        : HashMap(0, other.hash_, other.equal_, allocator)
+    {
+        reserve(other.size_);
+
+        // NOTE: Ключи заведомо различны, поэтому не ищем их, а сразу кладём в первую свободную ячейку.
+        for (const value_type& value : other) {
+            emplaceUnique(hashOf(value.first), value);
+        }
+    }
+
+    HashMap(HashMap&& other) noexcept
+        : hash_(std::move(other.hash_))
+        , equal_(std::move(other.equal_))
+        , allocator_(std::move(other.allocator_))
+        , control_(std::exchange(other.control_, const_cast<int8_t*>(detail::emptyGroup())))
+        , slots_(std::exchange(other.slots_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , growthLeft_(std::exchange(other.growthLeft_, 0))
+    {}
+
+    ~HashMap()
+    {
+        destroySlots();
+        deallocate();
+    }
+
+    HashMap& operator=(const HashMap& other)
+    {
+        if (this != &other) {
+            HashMap copy(other);
+            swap(copy);
+        }
+
+        return *this;
+    }
+
+    HashMap& operator=(HashMap&& other) noexcept
+    {
+        HashMap moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    HashMap& operator=(std::initializer_list<value_type> values)
+    {
+        clear();
+        insert(values);
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(control_, slots_, control_ + capacity_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(control_, slots_, control_ + capacity_);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(control_ + capacity_);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(control_ + capacity_);
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(AllocatorTraits::max_size(allocator_), std::numeric_limits<difference_type>::max());
+    }
+
+    /**
+     * @brief Удаляет все элементы, сохраняя выделенную память.
+     */
+    void clear() noexcept
+    {
+        destroySlots();
+
+        if (capacity_ > 0) {
+            std::memset(control_, detail::EMPTY, capacity_ + Group::WIDTH);
+        }
+
+        size_ = 0;
+        growthLeft_ = maxLoad(capacity_);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return emplaceKey(value.first, value);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return emplaceKey(value.first, std::move(value));
+    }
+
+    template<typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+    std::pair<iterator, bool> insert(P&& value)
+    {
+        return emplace(std::forward<P>(value));
+    }
+
+    iterator insert(const_iterator /* hint */, const value_type& value)
+    {
+        return insert(value).first;
+    }
+
+    iterator insert(const_iterator /* hint */, value_type&& value)
+    {
+        return insert(std::move(value)).first;
+    }
+
+    template<typename InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first) {
+            emplace(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> values)
+    {
+        insert(values.begin(), values.end());
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value)
+    {
+        return insertOrAssign(key, std::forward<M>(value));
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(Key&& key, M&& value)
+    {
+        return insertOrAssign(std::move(key), std::forward<M>(value));
+    }
+
+    /**
+     * @brief Создаёт элемент из аргументов и вставляет его, если элемента с таким ключом ещё нет.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        // NOTE: Для поиска нужен ключ, поэтому сначала создаём элемент целиком (кроме случая пары ключ-значение).
+        if constexpr (isKeyValue<Args...>()) {
+            return emplaceWithKey(std::forward<Args>(args)...);
+        } else {
+            value_type value(std::forward<Args>(args)...);
+            return emplaceKey(value.first, std::move(value));
+        }
+    }
+
+    template<typename... Args>
+    iterator emplace_hint(const_iterator /* hint */, Args&&... args)
+    {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    /**
+     * @brief Создаёт значение из аргументов, только если элемента с таким ключом ещё нет.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        return tryEmplace(key, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+    {
+        return tryEmplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Удаляет элемент.
+     * @return итератор на следующий элемент
+     */
+    iterator erase(const_iterator position)
+    {
+        const size_type index = static_cast<size_type>(position.control_ - control_);
+        eraseAt(index);
+
+        iterator next(control_ + index, slots_ + index, control_ + capacity_);
+        return next;
+    }
+
+    iterator erase(iterator position)
+    {
+        return erase(const_iterator(position));
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        while (first != last) {
+            first = erase(first);
+        }
+
+        return iterator(const_cast<int8_t*>(last.control_), const_cast<Slot*>(last.slot_), control_ + capacity_);
+    }
+
+    /**
+     * @return число удалённых элементов (0 или 1)
+     */
+    size_type erase(const Key& key)
+    {
+        const size_type index = findIndex(key, hashOf(key));
+
+        if (index == NOT_FOUND) {
+            return 0;
+        }
+
+        eraseAt(index);
+        return 1;
+    }
+
+    void swap(HashMap& other) noexcept
+    {
+        using std::swap;
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+        swap(allocator_, other.allocator_);
+        swap(control_, other.control_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growthLeft_, other.growthLeft_);
+    }
+
+    T& at(const Key& key)
+    {
+        const size_type index = findIndex(key, hashOf(key));
+
+        if (index == NOT_FOUND) {
+            throw std::out_of_range("HashMap::at");
+        }
+
+        return slots_[index].value.second;
+    }
+
+    const T& at(const Key& key) const
+    {
+        return const_cast<HashMap*>(this)->at(key);
+    }
+
+    T& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    T& operator[](Key&& key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    size_type count(const Key& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    iterator find(const Key& key)
+    {
+        return iteratorAt(findIndex(key, hashOf(key)));
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        return const_cast<HashMap*>(this)->find(key);
+    }
+
+    bool contains(const Key& key) const
+    {
+        return findIndex(key, hashOf(key)) != NOT_FOUND;
+    }
+
+    std::pair<iterator, iterator> equal_range(const Key& key)
+    {
+        const iterator it = find(key);
+        return { it, (it == end()) ? it : std::next(it) };
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+    {
+        const const_iterator it = find(key);
+        return { it, (it == end()) ? it : std::next(it) };
+    }
+
+    /**
+     * @brief Число ячеек таблицы (аналог числа корзин std::unordered_map).
+     */
+    size_type bucket_count() const noexcept
+    {
+        return capacity_;
+    }
+
+    float load_factor() const noexcept
+    {
+        return (capacity_ == 0) ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+
+    /**
+     * @brief Наибольший коэффициент заполнения. Он фиксирован: при открытой адресации больший замедлил бы поиск.
+     */
+    float max_load_factor() const noexcept
+    {
+        return 7.0f / 8.0f;
+    }
+
+    // NOTE: Оставлен для совместимости с std::unordered_map и ничего не меняет.
+    void max_load_factor(float /* loadFactor */) noexcept
+    {}
+
+    /**
+     * @brief Перестраивает таблицу под не менее чем bucketCount ячеек (но не меньше, чем нужно для текущих элементов).
+     * @note Заодно освобождает ячейки, помеченные удалёнными.
+     */
+    void rehash(size_type bucketCount)
+    {
+        if (bucketCount == 0 && size_ == 0) {
+            destroySlots();
+            deallocate();
+            return;
+        }
+
+        resize(std::max(capacityFor(size_), roundUp(bucketCount)));
+    }
+
+    /**
+     * @brief Выделяет память под count элементов, чтобы их вставка не вызывала рехэширования.
+     */
+    void reserve(size_type count)
+    {
+        if (count > size_ + growthLeft_) {
+            resize(capacityFor(count));
+        }
+    }
+
+    hasher hash_function() const
+    {
+        return hash_;
+    }
+
+    key_equal key_eq() const
+    {
+        return equal_;
+    }
+
+    friend bool operator==(const HashMap& left, const HashMap& right)
+    {
+        if (left.size() != right.size()) {
+            return false;
+        }
+
+        return std::all_of(left.begin(), left.end(), [&right](const value_type& value) {
+            const const_iterator it = right.find(value.first);
+            return (it != right.end()) && (it->second == value.second);
+        });
+    }
+
+    friend bool operator!=(const HashMap& left, const HashMap& right)
+    {
+        return !(left == right);
+    }
+
+    friend void swap(HashMap& left, HashMap& right) noexcept
+    {
+        left.swap(right);
+    }
+
+private:
+    static constexpr size_type NOT_FOUND = std::numeric_limits<size_type>::max();
+
+    /**
+     * @union Slot
+     * @brief Ячейка таблицы.
+     *
+     * Снаружи элемент виден как std::pair<const Key, T>, но при рехэшировании ключ нужно переместить, а не копировать
+     * (копия std::string - это выделение памяти). Поэтому, как map_slot_type в Abseil, ячейка позволяет обратиться
+     * к той же паре и как к std::pair<Key, T>, если их размещение в памяти совпадает (см. MUTABLE_KEYS).
+     */
+    union Slot
+    {
+        Slot() {}
+        ~Slot() {}
+
+        value_type value;
+        std::pair<Key, T> mutableValue;
+    };
+
+    static constexpr bool MUTABLE_KEYS = detail::isLayoutCompatible<Key, T>();
+
+    // NOTE: Перенос элемента в новую таблицу не выбрасывает исключений: ни хэш-функция, ни перемещение элемента.
+    static constexpr bool NOTHROW_TRANSFER = std::is_nothrow_invocable_v<const Hash&, const Key&>
+        && (MUTABLE_KEYS ? std::is_nothrow_move_constructible_v<std::pair<Key, T>>
+                         : std::is_nothrow_move_constructible_v<value_type>);
+
+    /**
+     * @class Iterator
+     * @brief Однонаправленный итератор: перебирает ячейки таблицы, пропуская свободные.
+     */
+    template<bool Const>
+    class Iterator final
+    {
+        friend class HashMap;
+
+        using Slot = std::conditional_t<Const, const typename HashMap::Slot, typename HashMap::Slot>;
+        using Value = std::conditional_t<Const, const typename HashMap::value_type, typename HashMap::value_type>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename HashMap::value_type;
+        using difference_type = typename HashMap::difference_type;
+        using reference = Value&;
+        using pointer = Value*;
+
+        Iterator() = default;
+
+        // NOTE: Неконстантный итератор неявно приводится к константному.
+        template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) noexcept
+            : control_(other.control_)
+            , slot_(other.slot_)
+            , end_(other.end_)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return slot_->value;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &slot_->value;
+        }
+
+        Iterator& operator++() noexcept
+        {
+            ++control_;
+            ++slot_;
+            skipFree();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+        {
+            return left.control_ == right.control_;
+        }
+
+        friend bool operator!=(const Iterator& left, const Iterator& right) noexcept
+        {
+            return left.control_ != right.control_;
+        }
+
+    private:
+        using Control = std::conditional_t<Const, const int8_t, int8_t>;
+
+        Iterator(Control* control, Slot* slot, const int8_t* end) noexcept
+            : control_(control)
+            , slot_(slot)
+            , end_(end)
+        {
+            skipFree();
+        }
+
+        explicit Iterator(Control* end) noexcept
+            : control_(end)
+            , end_(end)
+        {}
+
+        void skipFree() noexcept
+        {
+            while (control_ != end_ && *control_ < 0) {
+                ++control_;
+                ++slot_;
+            }
+        }
+
+    private:
+        template<bool>
+        friend class Iterator;
+
+        Control* control_ = nullptr;
+        Slot* slot_ = nullptr;
+        const int8_t* end_ = nullptr;
+    };
+
+    template<typename... Args>
+    static constexpr bool isKeyValue() noexcept
+    {
+        if constexpr (sizeof...(Args) == 2) {
+            return std::is_same_v<std::decay_t<std::tuple_element_t<0, std::tuple<Args...>>>, Key>;
+        } else {
+            return false;
+        }
+    }
+
+    uint64_t hashOf(const Key& key) const
+    {
+        return detail::mix(static_cast<uint64_t>(hash_(key)));
+    }
+
+    // NOTE: Старшие биты хэша выбирают группу, с которой начинается поиск, а младшие 7 бит хранятся в управляющем байте.
+    static size_type positionOf(uint64_t hash) noexcept
+    {
+        return static_cast<size_type>(hash >> 7);
+    }
+
+    static int8_t controlOf(uint64_t hash) noexcept
+    {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    /**
+     * @brief Наибольшее число элементов в таблице из capacity ячеек (7/8 от числа ячеек).
+     */
+    static size_type maxLoad(size_type capacity) noexcept
+    {
+        return capacity - capacity / 8;
+    }
+
+    static size_type roundUp(size_type count) noexcept
+    {
+        size_type capacity = Group::WIDTH;
+
+        while (capacity < count) {
+            capacity *= 2;
+        }
+
+        return capacity;
+    }
+
+    /**
+     * @brief Число ячеек (степень двойки, не меньше группы), вмещающее count элементов.
+     */
+    static size_type capacityFor(size_type count) noexcept
+    {
+        return roundUp(count + (count + 6) / 7);
+    }
+
+    iterator iteratorAt(size_type index) noexcept
+    {
+        return (index == NOT_FOUND) ? end() : iterator(control_ + index, slots_ + index, control_ + capacity_);
+    }
+
+    /**
+     * @brief Ищет ячейку с ключом, перебирая группы по квадратичной последовательности (она обходит все группы).
+     */
+    size_type findIndex(const Key& key, uint64_t hash) const
+    {
+        const size_type mask = capacityMask();
+        size_type position = positionOf(hash) & mask;
+
+        for (size_type step = Group::WIDTH;; step += Group::WIDTH) {
+            const Group group(control_ + position);
+
+            for (auto match = group.match(controlOf(hash)); match; match.dropLowest()) {
+                const size_type index = (position + match.lowest()) & mask;
+
+                if (equal_(slots_[index].value.first, key)) {
+                    return index;
+                }
+            }
+
+            // NOTE: Ключ не может лежать дальше группы с пустой ячейкой: вставка заняла бы её.
+            if (group.matchEmpty()) {
+                return NOT_FOUND;
+            }
+
+            position = (position + step) & mask;
+        }
+    }
+
+    /**
+     * @brief Первая свободная (пустая или удалённая) ячейка в последовательности поиска.
+     */
+    size_type findFree(uint64_t hash) const noexcept
+    {
+        const size_type mask = capacityMask();
+        size_type position = positionOf(hash) & mask;
+
+        for (size_type step = Group::WIDTH;; step += Group::WIDTH) {
+            const auto free = Group(control_ + position).matchEmptyOrDeleted();
+
+            if (free) {
+                return (position + free.lowest()) & mask;
+            }
+
+            position = (position + step) & mask;
+        }
+    }
+
+    size_type capacityMask() const noexcept
+    {
+        // NOTE: Для таблицы без ячеек маска 0: поиск читает одну пустую группу emptyGroup().
+        return (capacity_ == 0) ? 0 : capacity_ - 1;
+    }
+
+    /**
+     * @brief Записывает управляющий байт ячейки и его копию.
+     *
+     * Управляющие байты первой группы повторяются после последнего, чтобы группу, начинающуюся у конца таблицы,
+     * можно было прочитать одной загрузкой.
+     */
+    void setControl(size_type index, int8_t control) noexcept
+    {
+        control_[index] = control;
+
+        if (index < Group::WIDTH) {
+            control_[capacity_ + index] = control;
+        }
+    }
+
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> tryEmplace(K&& key, Args&&... args)
+    {
+        const uint64_t hash = hashOf(key);
+        const size_type index = findIndex(key, hash);
+
+        if (index != NOT_FOUND) {
+            return { iteratorAt(index), false };
+        }
+
+        return { iteratorAt(emplaceUnique(hash,
+                                          std::piecewise_construct,
+                                          std::forward_as_tuple(std::forward<K>(key)),
+                                          std::forward_as_tuple(std::forward<Args>(args)...))),
+                 true };
+    }
+
+    template<typename K, typename M>
+    std::pair<iterator, bool> insertOrAssign(K&& key, M&& value)
+    {
+        const auto result = tryEmplace(std::forward<K>(key), std::forward<M>(value));
+
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+
+        return result;
+    }
+
+    template<typename K, typename M>
+    std::pair<iterator, bool> emplaceWithKey(K&& key, M&& value)
+    {
+        return tryEmplace(std::forward<K>(key), std::forward<M>(value));
+    }
+
+    /**
+     * @brief Вставляет элемент, если ключа key ещё нет. Элемент создаётся из args лишь после поиска.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> emplaceKey(const Key& key, Args&&... args)
+    {
+        const uint64_t hash = hashOf(key);
+        const size_type index = findIndex(key, hash);
+
+        if (index != NOT_FOUND) {
+            return { iteratorAt(index), false };
+        }
+
+        return { iteratorAt(emplaceUnique(hash, std::forward<Args>(args)...)), true };
+    }
+
+    /**
+     * @brief Создаёт элемент, ключа которого заведомо нет в таблице, в первой свободной ячейке.
+     * @return номер ячейки
+     */
+    template<typename... Args>
+    size_type emplaceUnique(uint64_t hash, Args&&... args)
+    {
+        size_type index = findFree(hash);
+
+        // NOTE: Удалённую ячейку можно занять всегда, а пустую - лишь пока таблица не заполнена на 7/8.
+        if (growthLeft_ == 0 && control_[index] == detail::EMPTY) {
+            grow();
+            index = findFree(hash);
+        }
+
+        AllocatorTraits::construct(allocator_, &slots_[index].value, std::forward<Args>(args)...);
+
+        if (control_[index] == detail::EMPTY) {
+            --growthLeft_;
+        }
+
+        setControl(index, controlOf(hash));
+        ++size_;
+
+        return index;
+    }
+
+    /**
+     * @brief Расширяет таблицу вдвое или, если в ней много удалённых ячеек, перестраивает с прежним размером.
+     */
+    void grow()
+    {
+        if (capacity_ == 0) {
+            resize(Group::WIDTH);
+        } else if (size_ <= maxLoad(capacity_) / 2) {
+            resize(capacity_);
+        } else {
+            resize(capacity_ * 2);
+        }
+    }
+
+    void eraseAt(size_type index)
+    {
+        AllocatorTraits::destroy(allocator_, &slots_[index].value);
+        --size_;
+
+        // NOTE: Если вокруг ячейки меньше группы занятых ячеек подряд, ни один поиск не проходил через неё дальше,
+        // и её можно пометить пустой. Иначе помечаем удалённой, чтобы поиск не останавливался на ней.
+        const size_type before = (index - Group::WIDTH) & capacityMask();
+        const auto emptyAfter = Group(control_ + index).matchEmpty();
+        const auto emptyBefore = Group(control_ + before).matchEmpty();
+        const bool wasNeverFull = emptyBefore && emptyAfter
+            && (emptyAfter.trailingZeros() + emptyBefore.leadingZeros()) < Group::WIDTH;
+
+        setControl(index, wasNeverFull ? detail::EMPTY : detail::DELETED);
+
+        if (wasNeverFull) {
+            ++growthLeft_;
+        }
+    }
+
+    /**
+     * @brief Переносит элементы в новую таблицу из capacity ячеек.
+     *
+     * Если перенос элемента не выбрасывает исключений, элементы перемещаются по одному. Иначе они копируются,
+     * а старая таблица освобождается лишь после переноса всех элементов: при исключении таблица остаётся прежней.
+     */
+    void resize(size_type capacity)
+    {
+        int8_t* const oldControl = control_;
+        Slot* const oldSlots = slots_;
+        const size_type oldCapacity = capacity_;
+        const size_type oldGrowthLeft = growthLeft_;
+
+        ControlAllocator controlAllocator(allocator_);
+        SlotAllocator slotAllocator(allocator_);
+        control_ = ControlAllocatorTraits::allocate(controlAllocator, capacity + Group::WIDTH);
+
+        try {
+            slots_ = SlotAllocatorTraits::allocate(slotAllocator, capacity);
+        } catch (...) {
+            ControlAllocatorTraits::deallocate(controlAllocator, control_, capacity + Group::WIDTH);
+            control_ = oldControl;
+            throw;
+        }
+
+        std::memset(control_, detail::EMPTY, capacity + Group::WIDTH);
+        capacity_ = capacity;
+        growthLeft_ = maxLoad(capacity) - size_;
+
+        if constexpr (NOTHROW_TRANSFER) {
+            for (size_type i = 0; i < oldCapacity; ++i) {
+                if (oldControl[i] >= 0) {
+                    const uint64_t hash = hashOf(oldSlots[i].value.first);
+                    const size_type index = findFree(hash);
+
+                    transfer(slots_ + index, oldSlots + i);
+                    setControl(index, controlOf(hash));
+                }
+            }
+        } else {
+            try {
+                for (size_type i = 0; i < oldCapacity; ++i) {
+                    if (oldControl[i] >= 0) {
+                        const uint64_t hash = hashOf(oldSlots[i].value.first);
+                        const size_type index = findFree(hash);
+
+                        // NOTE: Некопируемый элемент остаётся лишь переместить (как std::move_if_noexcept).
+                        if constexpr (std::is_copy_constructible_v<value_type>) {
+                            AllocatorTraits::construct(allocator_, &slots_[index].value, oldSlots[i].value);
+                        } else {
+                            AllocatorTraits::construct(allocator_, &slots_[index].value, std::move(oldSlots[i].value));
+                        }
+
+                        setControl(index, controlOf(hash));
+                    }
+                }
+            } catch (...) {
+                // NOTE: Удаляем уже созданные копии и возвращаем прежнюю таблицу.
+                destroySlots();
+                deallocate(control_, slots_, capacity_);
+
+                control_ = oldControl;
+                slots_ = oldSlots;
+                capacity_ = oldCapacity;
+                growthLeft_ = oldGrowthLeft;
+                throw;
+            }
+
+            destroySlots(oldControl, oldSlots, oldCapacity);
+        }
+
+        deallocate(oldControl, oldSlots, oldCapacity);
+    }
+
+    /**
+     * @brief Перемещает элемент из ячейки from в пустую ячейку to и удаляет его из from.
+     */
+    void transfer(Slot* to, Slot* from) noexcept
+    {
+        if constexpr (MUTABLE_KEYS) {
+            AllocatorTraits::construct(allocator_, &to->mutableValue, std::move(from->mutableValue));
+            AllocatorTraits::destroy(allocator_, &from->mutableValue);
+        } else {
+            AllocatorTraits::construct(allocator_, &to->value, std::move(from->value));
+            AllocatorTraits::destroy(allocator_, &from->value);
+        }
+    }
+
+    void destroySlots() noexcept
+    {
+        destroySlots(control_, slots_, capacity_);
+    }
+
+    void destroySlots(const int8_t* control, Slot* slots, size_type capacity) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < capacity; ++i) {
+                if (control[i] >= 0) {
+                    AllocatorTraits::destroy(allocator_, &slots[i].value);
+                }
+            }
+        }
+    }
+
+    void deallocate() noexcept
+    {
+        deallocate(control_, slots_, capacity_);
+
+        control_ = const_cast<int8_t*>(detail::emptyGroup());
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        growthLeft_ = 0;
+    }
+
+    void deallocate(int8_t* control, Slot* slots, size_type capacity) noexcept
+    {
+        if (capacity > 0) {
+            ControlAllocator controlAllocator(allocator_);
+            SlotAllocator slotAllocator(allocator_);
+            ControlAllocatorTraits::deallocate(controlAllocator, control, capacity + Group::WIDTH);
+            SlotAllocatorTraits::deallocate(slotAllocator, slots, capacity);
+        }
+    }
+
+private:
+    Hash hash_;
+    KeyEqual equal_;
+    Allocator allocator_;
+
+    // NOTE: Таблица без ячеек не выделяет памяти и указывает на общую пустую группу, которую никто не изменяет.
+    int8_t* control_ = const_cast<int8_t*>(detail::emptyGroup());
+    Slot* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growthLeft_ = 0;
+};
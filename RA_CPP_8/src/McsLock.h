@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "SpinLock.h"
+
+/**
+ * @class McsLock
+ * @brief Очередь-блокировка MCS (Mellor-Crummey, Scott): справедливая (FIFO), и каждый поток ждёт на своём флаге.
+ *
+ * Ожидающие потоки выстраиваются в связный список узлов. Поток крутится на флаге своего узла, который лежит
+ * в его собственной строке кэша, а освобождающий блокировку поток пишет лишь во флаг следующего в очереди.
+ * Поэтому при передаче блокировки строка кэша переходит только к одному ядру, а не ко всем ожидающим сразу
+ * (как у SpinLock и TicketLock).
+ *
+ * Интерфейс обычный (lock()/unlock()), как у std::mutex: узлы очереди берутся из пула текущего потока,
+ * а узел владельца блокировки запоминается в ней самой.
+ * @warning Не подходит, если потоков больше, чем ядер (см. detail::SpinWait): здесь лучше SpinLock.
+ */
+class McsLock
+{
+public:
+    McsLock() noexcept = default;
+
+    McsLock(const McsLock& other) = delete;
+    McsLock& operator=(const McsLock& other) = delete;
+
+    void lock()
+    {
+        Node* const node = NodePool::local().acquire();
+        Node* const previous = tail_.exchange(node, std::memory_order_acq_rel);
+
+        if (previous != nullptr) {
+            // NOTE: Встаём в очередь за предыдущим потоком и ждём, пока он не передаст нам блокировку.
+            previous->next.store(node, std::memory_order_release);
+            detail::SpinWait spinWait;
+
+            while (node->locked.load(std::memory_order_acquire)) {
+                spinWait.wait();
+            }
+        }
+
+        owner_ = node;
+    }
+
+    bool try_lock()
+    {
+        Node* const node = NodePool::local().acquire();
+        Node* expected = nullptr;
+
+        if (tail_.compare_exchange_strong(expected, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+            owner_ = node;
+            return true;
+        }
+
+        NodePool::local().release(node);
+        return false;
+    }
+
+    void unlock()
+    {
+        Node* const node = owner_;
+        Node* next = node->next.load(std::memory_order_acquire);
+
+        if (next == nullptr) {
+            // NOTE: Очередь пуста - освобождаем блокировку, если никто не успел встать в очередь.
+            Node* expected = node;
+
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                NodePool::local().release(node);
+                return;
+            }
+
+            // NOTE: Поток уже встал в очередь, но ещё не связал с нами свой узел - дожидаемся этого.
+            detail::SpinWait spinWait;
+
+            while ((next = node->next.load(std::memory_order_acquire)) == nullptr) {
+                spinWait.wait();
+            }
+        }
+
+        next->locked.store(false, std::memory_order_release);
+
+        // NOTE: После передачи блокировки на узел больше никто не ссылается.
+        NodePool::local().release(node);
+    }
+
+private:
+    /**
+     * @struct Node
+     * @brief Узел очереди ожидающих потоков. Занимает свою строку кэша.
+     */
+    struct alignas(64) Node
+    {
+        std::atomic<Node*> next = nullptr;
+        std::atomic<bool> locked = true;
+    };
+
+    /**
+     * @class NodePool
+     * @brief Свободные узлы потока. Поток может держать сразу несколько McsLock, и для каждой ему нужен свой узел.
+     */
+    class NodePool final
+    {
+    public:
+        static NodePool& local()
+        {
+            thread_local NodePool pool;
+            return pool;
+        }
+
+        ~NodePool()
+        {
+            for (Node* node : free_) {
+                delete node;
+            }
+        }
+
+        Node* acquire()
+        {
+            Node* node = nullptr;
+
+            if (free_.empty()) {
+                node = new Node;
+            } else {
+                node = free_.back();
+                free_.pop_back();
+            }
+
+            node->next.store(nullptr, std::memory_order_relaxed);
+            node->locked.store(true, std::memory_order_relaxed);
+
+            return node;
+        }
+
+        void release(Node* node)
+        {
+            free_.push_back(node);
+        }
+
+    private:
+        std::vector<Node*> free_;
+    };
+
+private:
+    std::atomic<Node*> tail_ = nullptr;
+    Node* owner_ = nullptr; // NOTE: Узел владельца: его читает и пишет только поток, владеющий блокировкой.
+};
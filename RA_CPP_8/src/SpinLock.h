@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace detail
+{
+    /**
+     * @brief Подсказка процессору, что поток крутится в цикле ожидания.
+     *
+     * На x86 инструкция pause не даёт процессору забивать конвейер спекулятивными чтениями флага и освобождает ресурсы
+     * ядра для соседнего гиперпотока.
+     */
+    inline void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    /**
+     * @brief Усыпляет поток, пока значение word равно expected (или до пробуждения другим потоком).
+     * @note Без futex (не Linux) поток лишь уступает процессор.
+     */
+    inline void futexWait(std::atomic<uint32_t>& word, uint32_t expected) noexcept
+    {
+#ifdef __linux__
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex requires a plain 32-bit word");
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        if (word.load(std::memory_order_relaxed) == expected) {
+            std::this_thread::yield();
+        }
+#endif
+    }
+
+    /**
+     * @brief Будит до count потоков, спящих на word.
+     */
+    inline void futexWake([[maybe_unused]] std::atomic<uint32_t>& word, [[maybe_unused]] int count) noexcept
+    {
+#ifdef __linux__
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#endif
+    }
+
+    /**
+     * @class SpinWait
+     * @brief Одно ожидание в цикле: сначала крутится с pause, а затем уступает процессор другим потокам.
+     *
+     * Уступать нужно, когда потоков больше, чем ядер: иначе ожидающий поток тратит свой квант времени,
+     * пока вытесненный владелец блокировки не может её освободить.
+     *
+     * Справедливым блокировкам (TicketLock, McsLock) уступка помогает мало: блокировка передаётся строго следующему
+     * в очереди, даже если он вытеснен и не может её взять, и остальные ждут, пока планировщик не даст ему поработать.
+     * SpinLock же достаётся любому из работающих потоков.
+     */
+    class SpinWait final
+    {
+    public:
+        void wait(uint32_t pauses = 1) noexcept
+        {
+            if (spins_ < YIELD_AFTER) {
+                for (uint32_t i = 0; i < pauses; ++i) {
+                    cpuRelax();
+                }
+
+                spins_ += pauses;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        static constexpr uint32_t YIELD_AFTER = 4096;
+
+        uint32_t spins_ = 0;
+    };
+}
+
+/**
+ * @class SpinLock
+ * @brief Примитив синхронизации потоков в "горячем ожидании", который засыпает, если ждать приходится долго.
+ *
+ * Сначала поток крутится в цикле (короткие критические секции освобождаются быстрее, чем поток успел бы уснуть
+ * и проснуться), а исчерпав бюджет попыток, засыпает на futex до освобождения блокировки.
+ */
+class SpinLock
+{
+public:
+    SpinLock() noexcept = default;
+
+    SpinLock(const SpinLock& other) = delete;
+    SpinLock& operator=(const SpinLock& other) = delete;
+
+    void lock() noexcept
+    {
+        if (try_lock()) {
+            return;
+        }
+
+        // NOTE: Test-and-test-and-set: пока блокировка занята, крутимся на чтении. Чтение не отнимает строку кэша
+        // у других ядер, в отличие от test_and_set, который на каждой итерации записывает в неё.
+        uint32_t backoff = 1;
+
+        for (uint32_t spins = 0; spins < SPIN_BUDGET; spins += backoff) {
+            if (state_.load(std::memory_order_relaxed) == UNLOCKED && try_lock()) {
+                return;
+            }
+
+            // NOTE: Экспоненциальная задержка: чем дольше занята блокировка, тем реже потоки проверяют её все разом.
+            for (uint32_t i = 0; i < backoff; ++i) {
+                detail::cpuRelax();
+            }
+
+            backoff = std::min(backoff * 2, MAX_BACKOFF);
+        }
+
+        // NOTE: Бюджет исчерпан - засыпаем. Состояние CONTENDED сообщает владельцу, что при освобождении
+        // нужно разбудить ожидающий поток (без ожидающих unlock() обходится без системного вызова).
+        while (state_.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+            detail::futexWait(state_, CONTENDED);
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        uint32_t expected = UNLOCKED;
+        return state_.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        // NOTE: Обратите внимание, что все операции будут всегда внутри критической секции. А те, что снаружи - нет.
+        // Модель памяти для семантики acquire/release хорошо ложится спинлок.
+        if (state_.exchange(UNLOCKED, std::memory_order_release) == CONTENDED) {
+            detail::futexWake(state_, 1);
+        }
+    }
+
+private:
+    static constexpr uint32_t UNLOCKED = 0;
+    static constexpr uint32_t LOCKED = 1;
+    static constexpr uint32_t CONTENDED = 2; // NOTE: Занята, и, возможно, кто-то спит в ожидании.
+
+    static constexpr uint32_t SPIN_BUDGET = 4096; // NOTE: Порядка нескольких микросекунд ожидания.
+    static constexpr uint32_t MAX_BACKOFF = 64;
+
+    std::atomic<uint32_t> state_ = UNLOCKED;
+};
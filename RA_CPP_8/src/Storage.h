@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Epoch.h"
+#include "HashMap.h"
+
+#define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
+
+struct IStorage
+{
+    virtual ~IStorage() = default;
+    virtual std::optional<std::string> get(int key) const = 0;
+    virtual void set(int key, std::string_view value) = 0;
+};
+
+class MemoryStorage : public IStorage
+{
+public:
+    std::optional<std::string> get(int key) const override
+    {
+        const auto it = map_.find(key);
+        return (it == map_.cend()) ? std::nullopt : std::make_optional(it->second);
+    }
+
+    void set(int key, std::string_view value) override
+    {
+        map_[key] = value;
+    }
+
+private:
+    HashMap<int, std::string> map_;
+};
+
+// NOTE: Число сегментов ShardedStorage задаётся не параметром шаблона, а в конструкторе.
+constexpr size_t DYNAMIC_SHARDS = 0;
+
+/**
+ * @class ShardedStorage
+ * @brief Потокобезопасное хранилище, разбитое на сегменты: у каждого сегмента своё хранилище и своя блокировка.
+ *
+ * Сегмент выбирается по хэшу ключа, поэтому операции с ключами из разных сегментов не мешают друг другу,
+ * и запись блокирует лишь свой сегмент, а не всё хранилище (как ThreadSafeStorage).
+ *
+ * @tparam Storage хранилище одного сегмента
+ * @tparam ShardCount число сегментов (степень двойки) или DYNAMIC_SHARDS, чтобы задать его в конструкторе
+ */
+template<typename Storage, size_t ShardCount = DYNAMIC_SHARDS, REQUIRES(std::is_base_of_v<IStorage, Storage>)>
+class ShardedStorage : public IStorage
+{
+    static_assert((ShardCount & (ShardCount - 1)) == 0, "Number of shards must be a power of two");
+
+public:
+    template<size_t Count = ShardCount, REQUIRES(Count != DYNAMIC_SHARDS)>
+    ShardedStorage()
+        : shards_(ShardCount)
+    {}
+
+    /**
+     * @param shards число сегментов (округляется вверх до степени двойки)
+     */
+    template<size_t Count = ShardCount, REQUIRES(Count == DYNAMIC_SHARDS)>
+    explicit ShardedStorage(size_t shards = 4 * std::max(std::thread::hardware_concurrency(), 1u))
+        : shards_(roundUp(shards))
+    {}
+
+    std::optional<std::string> get(int key) const override
+    {
+        const Shard& shard = shardOf(key);
+
+        // NOTE: Читать сегмент могут сразу несколько потоков.
+        std::shared_lock lock(shard.mutex);
+        return shard.storage.get(key);
+    }
+
+    void set(int key, std::string_view value) override
+    {
+        Shard& shard = shardOf(key);
+
+        std::lock_guard lock(shard.mutex);
+        shard.storage.set(key, value);
+    }
+
+    size_t shards() const noexcept
+    {
+        return shards_.size();
+    }
+
+private:
+    /**
+     * @struct Shard
+     * @brief Сегмент хранилища.
+     *
+     * Каждый сегмент занимает свои строки кэша (64 байта - размер строки кэша x86 и большинства ARM),
+     * иначе захват блокировки одного сегмента вытеснял бы из кэша других ядер соседний сегмент.
+     */
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex;
+        Storage storage;
+    };
+
+    static size_t roundUp(size_t shards) noexcept
+    {
+        size_t count = 1;
+
+        while (count < shards) {
+            count *= 2;
+        }
+
+        return count;
+    }
+
+    size_t indexOf(int key) const noexcept
+    {
+        // NOTE: std::hash<int> не перемешивает биты, поэтому, например, ключи, кратные числу сегментов,
+        // попали бы в один сегмент. Перемешиваем их умножением на 2^64 / золотое сечение (хэш Фибоначчи).
+        const uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash >> 32) & (shards_.size() - 1);
+    }
+
+    Shard& shardOf(int key) noexcept
+    {
+        return shards_[indexOf(key)];
+    }
+
+    const Shard& shardOf(int key) const noexcept
+    {
+        return shards_[indexOf(key)];
+    }
+
+private:
+    std::vector<Shard> shards_;
+};
+
+/**
+ * @class ReadMostlyStorage
+ * @brief Потокобезопасное хранилище для преимущественного чтения: чтения не захватывают блокировок.
+ *
+ * Хэш-таблица со списками в корзинах, узлы которых не изменяются: запись создаёт новый узел и атомарно подменяет им
+ * старый, а при росте таблицы строится новая таблица и атомарно подменяет старую. Читатель видит либо старую,
+ * либо новую версию. Убранные узлы и таблицы удаляются лишь тогда, когда их уже не может читать ни один поток
+ * (см. EpochDomain), поэтому читатели пишут только в свою ячейку эпохи и не перебрасывают друг другу строку кэша
+ * мьютекса, как при std::shared_lock. Записи выполняются по очереди под одним мьютексом.
+ *
+ * @note Цена отсутствия блокировок - EpochGuard и переходы по узлам списков вместо открытой адресации HashMap.
+ * Без конкуренции за мьютекс (один поток, 100% чтений: storage_benchmark --threads 1 --writes 0) хранилище медленнее
+ * одного MemoryStorage под мьютексом ("single lock"): около 12 млн операций в секунду против 19 млн. Из них
+ * EpochGuard стоит около 2 нс на чтение (см. EpochDomain::enter), а с барьером в процессоре стоил бы 10 нс.
+ * Выигрыш появляется, когда читатели на разных ядрах начинают перебрасывать друг другу строку кэша общего мьютекса.
+ */
+class ReadMostlyStorage : public IStorage
+{
+public:
+    ReadMostlyStorage()
+        : table_(new Table(INITIAL_BUCKETS))
+    {}
+
+    ReadMostlyStorage(const ReadMostlyStorage& other) = delete;
+    ReadMostlyStorage& operator=(const ReadMostlyStorage& other) = delete;
+
+    // WARNING: К моменту удаления хранилища ни один поток не должен его читать.
+    ~ReadMostlyStorage()
+    {
+        for (const Retired& retired : retired_) {
+            retired.destroy(retired.object);
+        }
+
+        delete table_.load(std::memory_order_relaxed);
+    }
+
+    std::optional<std::string> get(int key) const override
+    {
+        EpochGuard guard;
+
+        const Table* const table = table_.load(std::memory_order_acquire);
+
+        for (const Node* node = table->bucketOf(key).load(std::memory_order_acquire); node != nullptr;
+             node = node->next.load(std::memory_order_acquire)) {
+            if (node->key == key) {
+                return node->value;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void set(int key, std::string_view value) override
+    {
+        std::lock_guard lock(mutex_);
+
+        Table* const table = table_.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = &table->bucketOf(key);
+
+        for (Node* node = link->load(std::memory_order_relaxed); node != nullptr;
+             link = &node->next, node = link->load(std::memory_order_relaxed)) {
+            if (node->key == key) {
+                // NOTE: Узел, который может читать другой поток, не изменяем, а подменяем копией с новым значением.
+                link->store(new Node(key, value, node->next.load(std::memory_order_relaxed)), std::memory_order_release);
+                retire(node);
+                return;
+            }
+        }
+
+        std::atomic<Node*>& bucket = table->bucketOf(key);
+        bucket.store(new Node(key, value, bucket.load(std::memory_order_relaxed)), std::memory_order_release);
+
+        if (++size_ > table->buckets.size()) {
+            grow(*table);
+        }
+    }
+
+private:
+    static constexpr size_t INITIAL_BUCKETS = 64;
+
+    // NOTE: Удаляем убранные объекты пачками, чтобы не обходить ячейки эпох при каждой записи.
+    static constexpr size_t RECLAIM_BATCH = 64;
+
+    struct Node
+    {
+        Node(int key, std::string_view value, Node* next)
+            : key(key)
+            , value(value)
+            , next(next)
+        {}
+
+        const int key;
+        const std::string value;
+        std::atomic<Node*> next;
+    };
+
+    struct Table
+    {
+        explicit Table(size_t size)
+            : buckets(size)
+        {}
+
+        ~Table()
+        {
+            for (std::atomic<Node*>& bucket : buckets) {
+                for (Node* node = bucket.load(std::memory_order_relaxed); node != nullptr;) {
+                    Node* const next = node->next.load(std::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            }
+        }
+
+        std::atomic<Node*>& bucketOf(int key) noexcept
+        {
+            return buckets[indexOf(key)];
+        }
+
+        const std::atomic<Node*>& bucketOf(int key) const noexcept
+        {
+            return buckets[indexOf(key)];
+        }
+
+        size_t indexOf(int key) const noexcept
+        {
+            // NOTE: Хэш Фибоначчи, как и в ShardedStorage: число корзин - степень двойки.
+            const uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(hash >> 32) & (buckets.size() - 1);
+        }
+
+        std::vector<std::atomic<Node*>> buckets;
+    };
+
+    /**
+     * @struct Retired
+     * @brief Убранный объект, который удаляется после эпохи epoch.
+     */
+    struct Retired
+    {
+        void* object;
+        void (*destroy)(void*);
+        uint64_t epoch;
+    };
+
+    /**
+     * @brief Строит таблицу вдвое больше (с копиями узлов) и подменяет ею текущую.
+     */
+    void grow(Table& table)
+    {
+        auto* const grown = new Table(table.buckets.size() * 2);
+
+        for (std::atomic<Node*>& bucket : table.buckets) {
+            for (Node* node = bucket.load(std::memory_order_relaxed); node != nullptr;
+                 node = node->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node*>& target = grown->bucketOf(node->key);
+                target.store(new Node(node->key, node->value, target.load(std::memory_order_relaxed)),
+                             std::memory_order_relaxed);
+            }
+        }
+
+        // NOTE: Новая таблица становится видна читателям целиком: release публикует и все её узлы.
+        table_.store(grown, std::memory_order_release);
+        retire(&table);
+    }
+
+    template <typename T>
+    void retire(T* object)
+    {
+        retired_.push_back({ object, [](void* pointer) { delete static_cast<T*>(pointer); },
+                             EpochDomain::instance().retire() });
+
+        if (retired_.size() >= reclaimAt_) {
+            reclaim();
+        }
+    }
+
+    void reclaim()
+    {
+        const uint64_t safeEpoch = EpochDomain::instance().safeEpoch();
+
+        const auto it = std::partition(retired_.begin(), retired_.end(), [safeEpoch](const Retired& retired) {
+            return retired.epoch >= safeEpoch;
+        });
+
+        std::for_each(it, retired_.end(), [](const Retired& retired) { retired.destroy(retired.object); });
+        retired_.erase(it, retired_.end());
+
+        // NOTE: Если долгий читатель не дал удалить большую часть объектов, следующую попытку откладываем, пока список
+        // не вырастет вдвое: иначе каждая запись обходила бы ячейки эпох и выполняла барьер (см. EpochDomain::safeEpoch).
+        reclaimAt_ = std::max(RECLAIM_BATCH, 2 * retired_.size());
+    }
+
+private:
+    std::atomic<Table*> table_;
+
+    std::mutex mutex_; // NOTE: Упорядочивает записи; чтения его не захватывают.
+    size_t size_ = 0;
+    std::vector<Retired> retired_;
+    size_t reclaimAt_ = RECLAIM_BATCH; // NOTE: Размер списка, при котором пора удалять объекты.
+};
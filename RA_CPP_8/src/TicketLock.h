@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "SpinLock.h"
+
+/**
+ * @class TicketLock
+ * @brief Справедливая блокировка "по талонам": потоки получают её строго в порядке очереди (FIFO).
+ *
+ * Поток берёт талон (атомарный инкремент счётчика выданных талонов) и ждёт, пока номер обслуживаемого талона
+ * не станет равен его номеру. В отличие от SpinLock, ни один поток не может бесконечно проигрывать гонку за флаг.
+ * @note Все ожидающие потоки читают одну строку кэша, поэтому при большом числе ядер лучше подходит McsLock.
+ * @warning Не подходит, если потоков больше, чем ядер (см. detail::SpinWait): здесь лучше SpinLock.
+ */
+class TicketLock
+{
+public:
+    TicketLock() noexcept = default;
+
+    TicketLock(const TicketLock& other) = delete;
+    TicketLock& operator=(const TicketLock& other) = delete;
+
+    void lock() noexcept
+    {
+        const uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+        detail::SpinWait spinWait;
+
+        for (uint32_t serving = serving_.load(std::memory_order_acquire); serving != ticket;
+             serving = serving_.load(std::memory_order_acquire)) {
+            // NOTE: Ждём тем дольше, чем больше потоков в очереди перед нами: так реже читаем общую строку кэша.
+            spinWait.wait(std::min((ticket - serving) * PAUSES_PER_WAITER, MAX_PAUSES));
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        // NOTE: Блокировка свободна, если следующий выданный талон и будет обслуживаться.
+        uint32_t ticket = serving_.load(std::memory_order_acquire);
+        return next_.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        // NOTE: Номер обслуживаемого талона меняет лишь владелец блокировки, поэтому атомарный инкремент не нужен.
+        serving_.store(serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    static constexpr uint32_t PAUSES_PER_WAITER = 16;
+    static constexpr uint32_t MAX_PAUSES = 512;
+
+    // NOTE: Счётчики в разных строках кэша: выдача талонов новым потокам не мешает ожидающим следить за очередью.
+    alignas(64) std::atomic<uint32_t> next_ = 0;
+    alignas(64) std::atomic<uint32_t> serving_ = 0;
+};
@@ -0,0 +1,200 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CommandLine.h"
+#include "HashMap.h"
+
+// NOTE: Сравнение HashMap и std::unordered_map: среднее время одной операции (в наносекундах) на случайных ключах.
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Параметры замеров.
+     */
+    struct Options final
+    {
+        size_t size = 1000000; // NOTE: Число элементов.
+        size_t repeats = 3;    // NOTE: Из нескольких повторов берётся лучший.
+    };
+
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view key = argv[i];
+
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            const std::string_view value = argv[++i];
+            bool valid = false;
+
+            if (key == "--size") {
+                valid = parseNumber(value, options.size);
+            } else if (key == "--repeats") {
+                valid = parseNumber(value, options.repeats);
+            }
+
+            if (!valid) {
+                return std::nullopt;
+            }
+        }
+
+        return options;
+    }
+
+    /**
+     * @struct Result
+     * @brief Время одной операции каждого вида (в наносекундах).
+     */
+    struct Result
+    {
+        double insert = 0;
+        double findHit = 0;
+        double findMiss = 0;
+        double iterate = 0;
+        double erase = 0;
+    };
+
+    template<typename Function>
+    double nanosecondsPerOperation(size_t operations, Function&& function)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        function();
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+        return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(operations);
+    }
+
+    /**
+     * @brief Замеряет операции с контейнером Map на ключах keys (первая половина вставляется, вторая - ищется как
+     *        отсутствующая).
+     */
+    template<typename Map, typename Key>
+    Result measure(const std::vector<Key>& keys)
+    {
+        const size_t half = keys.size() / 2;
+
+        Result result;
+        Map map;
+        size_t checksum = 0; // NOTE: Не даёт компилятору выбросить поиск, результат которого не используется.
+
+        result.insert = nanosecondsPerOperation(half, [&] {
+            for (size_t i = 0; i < half; ++i) {
+                map.emplace(keys[i], i);
+            }
+        });
+
+        result.findHit = nanosecondsPerOperation(half, [&] {
+            for (size_t i = 0; i < half; ++i) {
+                checksum += map.find(keys[i])->second;
+            }
+        });
+
+        result.findMiss = nanosecondsPerOperation(keys.size() - half, [&] {
+            for (size_t i = half; i < keys.size(); ++i) {
+                checksum += (map.find(keys[i]) == map.end());
+            }
+        });
+
+        result.iterate = nanosecondsPerOperation(map.size(), [&] {
+            for (const auto& [key, value] : map) {
+                checksum += value;
+            }
+        });
+
+        result.erase = nanosecondsPerOperation(half, [&] {
+            for (size_t i = 0; i < half; ++i) {
+                checksum += map.erase(keys[i]);
+            }
+        });
+
+        if (checksum == 0) {
+            std::cerr << "Unexpected checksum\n";
+        }
+
+        return result;
+    }
+
+    template<typename Map, typename Key>
+    Result best(const std::vector<Key>& keys, size_t repeats)
+    {
+        Result best = measure<Map>(keys);
+
+        for (size_t i = 1; i < repeats; ++i) {
+            const Result result = measure<Map>(keys);
+
+            best.insert = std::min(best.insert, result.insert);
+            best.findHit = std::min(best.findHit, result.findHit);
+            best.findMiss = std::min(best.findMiss, result.findMiss);
+            best.iterate = std::min(best.iterate, result.iterate);
+            best.erase = std::min(best.erase, result.erase);
+        }
+
+        return best;
+    }
+
+    template<typename Key>
+    void compare(std::string_view title, const std::vector<Key>& keys, size_t repeats)
+    {
+        const Result standard = best<std::unordered_map<Key, size_t>>(keys, repeats);
+        const Result flat = best<HashMap<Key, size_t>>(keys, repeats);
+
+        const auto print = [](std::string_view operation, double standard, double flat) {
+            std::cout << std::setw(12) << operation << std::setw(16) << standard << std::setw(16) << flat << "\n";
+        };
+
+        std::cout << title << ", " << keys.size() / 2 << " elements (ns/op)\n"
+                  << std::setw(12) << "operation" << std::setw(16) << "unordered_map" << std::setw(16) << "HashMap" << "\n"
+                  << std::fixed << std::setprecision(1);
+
+        print("insert", standard.insert, flat.insert);
+        print("find hit", standard.findHit, flat.findHit);
+        print("find miss", standard.findMiss, flat.findMiss);
+        print("iterate", standard.iterate, flat.iterate);
+        print("erase", standard.erase, flat.erase);
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--size <elements>] [--repeats <count>]\n";
+        return 1;
+    }
+
+    // NOTE: Ключей вдвое больше, чем элементов: вторая половина нужна для поиска отсутствующих ключей.
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> numbers(options->size * 2);
+
+    for (uint64_t& number : numbers) {
+        number = random();
+    }
+
+    compare("uint64_t keys", numbers, options->repeats);
+
+    std::vector<std::string> strings;
+    strings.reserve(numbers.size());
+
+    for (const uint64_t number : numbers) {
+        strings.push_back("key:" + std::to_string(number));
+    }
+
+    compare("std::string keys", strings, options->repeats);
+
+    return 0;
+}
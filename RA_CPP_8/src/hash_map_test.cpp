@@ -0,0 +1,260 @@
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "HashMap.h"
+
+// NOTE: Проверка HashMap: случайные операции выполняются над HashMap и над std::unordered_map, после каждой
+// сверяется результат операции, а периодически - всё содержимое. Отдельно проверяется, что исключение при
+// рехэшировании оставляет таблицу прежней. При расхождении программа выводит его и завершается с кодом 1.
+
+namespace
+{
+    /**
+     * @class Checker
+     * @brief Считает проверки и выводит проваленные.
+     */
+    class Checker final
+    {
+    public:
+        void expect(bool condition, std::string_view what)
+        {
+            if (!condition) {
+                std::cerr << "FAILED: " << what << "\n";
+                ++failures_;
+            }
+        }
+
+        int failures() const noexcept
+        {
+            return failures_;
+        }
+
+    private:
+        int failures_ = 0;
+    };
+
+    template<typename Map, typename Reference>
+    bool sameContents(const Map& map, const Reference& reference)
+    {
+        if (map.size() != reference.size()) {
+            return false;
+        }
+
+        size_t visited = 0;
+
+        for (const auto& [key, value] : map) {
+            const auto it = reference.find(key);
+
+            if (it == reference.end() || it->second != value) {
+                return false;
+            }
+
+            ++visited;
+        }
+
+        return visited == reference.size();
+    }
+
+    template<typename Key>
+    Key makeKey(uint64_t number);
+
+    template<>
+    int makeKey<int>(uint64_t number)
+    {
+        return static_cast<int>(number);
+    }
+
+    // NOTE: Длинные строки не помещаются в буфер малой строки: при рехэшировании ключи перемещаются, а не копируются.
+    template<>
+    std::string makeKey<std::string>(uint64_t number)
+    {
+        return "key-with-a-heap-allocated-buffer-" + std::to_string(number);
+    }
+
+    /**
+     * @brief Случайные вставки, поиски и удаления над небольшим множеством ключей: таблица многократно растёт,
+     *        копит удалённые ячейки и перестраивается.
+     */
+    template<typename Key>
+    void checkRandomOperations(Checker& checker, uint64_t seed, size_t operations, size_t keys)
+    {
+        HashMap<Key, int> map;
+        std::unordered_map<Key, int> reference;
+        std::mt19937_64 random(seed);
+
+        for (size_t operation = 0; operation < operations; ++operation) {
+            const Key key = makeKey<Key>(random() % keys);
+            const int value = static_cast<int>(random() % 1000);
+
+            switch (random() % 8) {
+                case 0: {
+                    const bool inserted = map.insert({ key, value }).second;
+                    checker.expect(inserted == reference.insert({ key, value }).second, "insert");
+                    break;
+                }
+                case 1: {
+                    const bool inserted = map.try_emplace(key, value).second;
+                    checker.expect(inserted == reference.try_emplace(key, value).second, "try_emplace");
+                    break;
+                }
+                case 2:
+                    map[key] = value;
+                    reference[key] = value;
+                    break;
+                case 3:
+                case 4:
+                    checker.expect(map.erase(key) == reference.erase(key), "erase");
+                    break;
+                case 5: {
+                    const auto it = map.find(key);
+                    const auto expected = reference.find(key);
+                    checker.expect((it == map.end()) == (expected == reference.end()), "find");
+                    checker.expect(it == map.end() || it->second == expected->second, "find value");
+                    break;
+                }
+                case 6:
+                    if (random() % 64 == 0) {
+                        map.rehash(0);
+                    } else {
+                        map.reserve(reference.size() + random() % 64);
+                    }
+                    break;
+                default:
+                    if (random() % 256 == 0) {
+                        map.clear();
+                        reference.clear();
+                    }
+                    break;
+            }
+
+            if (operation % 1024 == 0) {
+                checker.expect(sameContents(map, reference), "contents");
+            }
+        }
+
+        checker.expect(sameContents(map, reference), "final contents");
+
+        const HashMap<Key, int> copy(map);
+        checker.expect(sameContents(copy, reference), "copy");
+
+        HashMap<Key, int> moved(std::move(map));
+        checker.expect(sameContents(moved, reference), "move");
+    }
+
+    /**
+     * @struct ThrowingKey
+     * @brief Ключ, копирование которого выбрасывает исключение, пока установлен флаг.
+     */
+    struct ThrowingKey
+    {
+        static inline bool throwOnCopy = false;
+
+        int value = 0;
+
+        explicit ThrowingKey(int value)
+            : value(value)
+        {}
+
+        ThrowingKey(const ThrowingKey& other)
+            : value(other.value)
+        {
+            if (throwOnCopy) {
+                throw std::runtime_error("ThrowingKey copy");
+            }
+        }
+
+        // NOTE: Перемещение тоже может выбросить исключение: HashMap придётся копировать ключи при рехэшировании.
+        ThrowingKey(ThrowingKey&& other) noexcept(false)
+            : ThrowingKey(static_cast<const ThrowingKey&>(other))
+        {}
+
+        bool operator==(const ThrowingKey& other) const noexcept
+        {
+            return value == other.value;
+        }
+    };
+
+    struct ThrowingKeyHash
+    {
+        size_t operator()(const ThrowingKey& key) const noexcept
+        {
+            return std::hash<int>()(key.value);
+        }
+    };
+
+    void checkThrowingRehash(Checker& checker)
+    {
+        HashMap<ThrowingKey, std::string, ThrowingKeyHash> map;
+        std::map<int, std::string> reference;
+
+        // NOTE: Заполняем таблицу до предела, чтобы следующая вставка вызвала рехэширование.
+        for (int i = 0; map.size() < map.bucket_count() * 7 / 8 || map.empty(); ++i) {
+            map.try_emplace(ThrowingKey(i), std::to_string(i));
+            reference.emplace(i, std::to_string(i));
+        }
+
+        const size_t capacity = map.bucket_count();
+        bool thrown = false;
+        ThrowingKey::throwOnCopy = true;
+
+        try {
+            map.reserve(map.size() + 1);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+
+        ThrowingKey::throwOnCopy = false;
+
+        checker.expect(thrown, "rehash with a throwing key throws");
+        checker.expect(map.bucket_count() == capacity, "rehash failure keeps the table");
+        checker.expect(map.size() == reference.size(), "rehash failure keeps the size");
+
+        size_t found = 0;
+
+        for (const auto& [key, value] : reference) {
+            const auto it = map.find(ThrowingKey(key));
+            found += (it != map.end() && it->second == value) ? 1 : 0;
+        }
+
+        checker.expect(found == reference.size(), "rehash failure keeps every element");
+
+        size_t visited = 0;
+
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            ++visited;
+        }
+
+        checker.expect(visited == reference.size(), "rehash failure keeps iteration");
+
+        // NOTE: После неудачи таблица продолжает работать.
+        map.reserve(map.size() + 1);
+        checker.expect(map.bucket_count() > capacity && map.size() == reference.size(), "rehash after failure");
+    }
+}
+
+int main()
+{
+    Checker checker;
+
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        checkRandomOperations<int>(checker, seed, 200000, 2000);
+        checkRandomOperations<std::string>(checker, seed, 100000, 500);
+    }
+
+    checkThrowingRehash(checker);
+
+    if (checker.failures() > 0) {
+        std::cerr << checker.failures() << " check(s) failed\n";
+        return 1;
+    }
+
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "CommandLine.h"
+#include "McsLock.h"
+#include "SpinLock.h"
+#include "TicketLock.h"
+
+// NOTE: Замеры блокировок под конкуренцией: потоки в течение заданного времени захватывают одну блокировку
+// и изменяют общие данные. Кроме пропускной способности выводится справедливость - отношение числа захватов
+// самого "обделённого" потока к числу захватов самого удачливого (1 - все потоки получили поровну).
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Параметры замеров.
+     */
+    struct Options final
+    {
+        size_t threads = 64;     // NOTE: Наибольшее число потоков.
+        size_t duration = 200;   // NOTE: Длительность одного замера (в миллисекундах).
+        size_t work = 0;         // NOTE: Работа вне критической секции (число инструкций pause).
+    };
+
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view key = argv[i];
+
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            const std::string_view value = argv[++i];
+            bool valid = false;
+
+            if (key == "--threads") {
+                valid = parseNumber(value, options.threads);
+            } else if (key == "--duration") {
+                valid = parseNumber(value, options.duration);
+            } else if (key == "--work") {
+                valid = parseNumber(value, options.work, 0);
+            }
+
+            if (!valid) {
+                return std::nullopt;
+            }
+        }
+
+        return options;
+    }
+
+    /**
+     * @struct Result
+     * @brief Итоги одного замера.
+     */
+    struct Result
+    {
+        double operationsPerSecond = 0;
+        double fairness = 0;
+        bool consistent = true; // NOTE: Блокировка не пропустила в критическую секцию два потока сразу.
+    };
+
+    /**
+     * @struct alignas(64) Counter
+     * @brief Счётчик захватов одного потока в своей строке кэша, чтобы потоки не мешали друг другу вне блокировки.
+     */
+    struct alignas(64) Counter
+    {
+        uint64_t value = 0;
+    };
+
+    template<typename Lock>
+    Result measure(const Options& options, size_t threadCount)
+    {
+        Lock lock;
+        uint64_t shared[8] = {}; // NOTE: Данные под защитой блокировки (одна строка кэша).
+
+        std::atomic<bool> start = false;
+        std::atomic<bool> stop = false;
+        std::vector<Counter> counters(threadCount);
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&, i] {
+                uint64_t acquisitions = 0;
+
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                while (!stop.load(std::memory_order_relaxed)) {
+                    {
+                        std::lock_guard guard(lock);
+
+                        for (uint64_t& value : shared) {
+                            ++value;
+                        }
+                    }
+
+                    ++acquisitions;
+
+                    for (size_t j = 0; j < options.work; ++j) {
+                        detail::cpuRelax();
+                    }
+                }
+
+                counters[i].value = acquisitions;
+            });
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        start.store(true, std::memory_order_release);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.duration));
+        stop.store(true, std::memory_order_relaxed);
+
+        std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        const auto [least, most] = std::minmax_element(counters.begin(), counters.end(),
+            [](const Counter& left, const Counter& right) { return left.value < right.value; });
+
+        uint64_t total = 0;
+
+        for (const Counter& counter : counters) {
+            total += counter.value;
+        }
+
+        Result result;
+        result.operationsPerSecond = static_cast<double>(total) / seconds;
+        result.fairness = (most->value == 0) ? 0.0 : static_cast<double>(least->value) / static_cast<double>(most->value);
+        result.consistent = std::all_of(std::begin(shared), std::end(shared), [total](uint64_t value) {
+            return value == total;
+        });
+
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--threads <max>] [--duration <ms>] [--work <pauses>]\n";
+        return 1;
+    }
+
+    struct Variant
+    {
+        std::string name;
+        std::function<Result(const Options&, size_t)> measure;
+    };
+
+    const std::vector<Variant> variants = {
+        { "std::mutex", measure<std::mutex> },
+        { "SpinLock", measure<SpinLock> },
+        { "TicketLock", measure<TicketLock> },
+        { "McsLock", measure<McsLock> }
+    };
+
+    std::cout << "Duration: " << options->duration << " ms, work outside the lock: " << options->work << " pauses\n"
+              << std::left << std::setw(10) << "threads" << std::setw(14) << "lock" << std::setw(16) << "ops/s"
+              << "fairness" << "\n";
+
+    // NOTE: Степени двойки и ровно указанное число потоков, даже если оно не степень двойки.
+    std::vector<size_t> threadCounts;
+
+    for (size_t threads = 1; threads < options->threads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+
+    threadCounts.push_back(options->threads);
+
+    bool consistent = true;
+
+    for (const size_t threads : threadCounts) {
+        for (const Variant& variant : variants) {
+            const Result result = variant.measure(*options, threads);
+            consistent = consistent && result.consistent;
+
+            std::cout << std::setw(10) << threads << std::setw(14) << variant.name
+                      << std::setw(16) << std::fixed << std::setprecision(0) << result.operationsPerSecond
+                      << std::setprecision(2) << result.fairness
+                      << (result.consistent ? "" : " (mutual exclusion violated!)") << "\n";
+        }
+    }
+
+    return consistent ? 0 : 1;
+}
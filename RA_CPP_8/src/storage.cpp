@@ -1,71 +1,15 @@
 #include <algorithm>
-#include <atomic>
 #include <functional>
 #include <iostream>
 #include <optional>
 #include <shared_mutex>
 #include <string>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
-using namespace::std::chrono_literals;
-
-#define REQUIRES(...) typename = std::enable_if_t<__VA_ARGS__>
-
-/**
- * @class SpinLock
- * @brief Примитив синхронизации потоков в "горячем ожидании".
- */
-class SpinLock final
-{
-public:
-    SpinLock() noexcept
-        : flag_ ATOMIC_FLAG_INIT
-    {}
-
-    void lock() noexcept
-    {
-        // NOTE: Конкурирующий поток крутится в цикле, пока блокировка не будет освобождена (то самое горячее ожидание).
-        while(flag_.test_and_set(std::memory_order_acquire));
-    }
-
-    void unlock() noexcept
-    {
-        // NOTE: По выходу из критической секции поднимаем флаг.
-        // Обратите внимание, что все операции будут всегда внутри критической секции. А те, что снаружи - нет.
-        // Модель памяти для семантики acquire/release хорошо ложится спинлок.
-        flag_.clear(std::memory_order_release);
-    }
-
-private:
-    std::atomic_flag flag_;
-};
-
-struct IStorage
-{
-    virtual ~IStorage() = default;
-    virtual std::optional<std::string> get(int key) const = 0;
-    virtual void set(int key, std::string_view value) = 0;
-};
-
-class MemoryStorage : public IStorage
-{
-public:
-    std::optional<std::string> get(int key) const override
-    {
-        const auto it = map_.find(key);
-        return (it == map_.cend()) ? std::nullopt : std::make_optional(it->second);
-    }
-
-    void set(int key, std::string_view value) override
-    {
-        map_[key] = value;
-    }
+#include "Storage.h"
 
-private:
-    std::unordered_map<int, std::string> map_;
-};
+using namespace::std::chrono_literals;
 
 // NOTE: Реализуем настоящее потоко-безопасное хранилище.
 // Сравните с примером из 4-го занятия, где мы пренебрегли защитой метода get().
@@ -134,5 +78,21 @@ int main()
 
     std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
 
+    // NOTE: Хранилище, разбитое на сегменты: потоки, пишущие разные ключи, как правило, не ждут друг друга.
+    ShardedStorage<MemoryStorage> sharded;
+    std::vector<std::thread> writers;
+
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([i, &sharded] {
+            for (int key = i * 1000; key < (i + 1) * 1000; ++key) {
+                sharded.set(key, std::to_string(key));
+            }
+        });
+    }
+
+    std::for_each(writers.begin(), writers.end(), std::mem_fn(&std::thread::join));
+
+    std::cout << sharded.get(1234) << " (" << sharded.shards() << " shards)" << "\n";
+
     return 0;
 }
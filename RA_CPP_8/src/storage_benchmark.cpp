@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "CommandLine.h"
+#include "Storage.h"
+
+// NOTE: Замеры пропускной способности потокобезопасных хранилищ (операций в секунду) при разном числе потоков
+// и разной доле записей. Каждый поток выполняет одинаковое число случайных операций со случайными ключами.
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Параметры замеров.
+     */
+    struct Options final
+    {
+        size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1); // NOTE: Наибольшее число потоков.
+        size_t operations = 1000000; // NOTE: Число операций одного потока.
+        size_t writes = 50;          // NOTE: Доля записей (в процентах).
+        size_t keys = 100000;
+        size_t shards = 0;           // NOTE: 0 - число сегментов по умолчанию.
+    };
+
+    // NOTE: Число сегментов округляется вверх до степени двойки: ограничиваем его, чтобы округление не переполнилось.
+    constexpr size_t MAX_SHARDS = 1 << 20;
+
+    std::optional<Options> parseOptions(int argc, char** argv)
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view key = argv[i];
+
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+
+            const std::string_view value = argv[++i];
+            bool valid = false;
+
+            if (key == "--threads") {
+                valid = parseNumber(value, options.threads);
+            } else if (key == "--operations") {
+                valid = parseNumber(value, options.operations);
+            } else if (key == "--writes") {
+                valid = parseNumber(value, options.writes, 0, 100);
+            } else if (key == "--keys") {
+                valid = parseNumber(value, options.keys);
+            } else if (key == "--shards") {
+                valid = parseNumber(value, options.shards, 0, MAX_SHARDS);
+            }
+
+            if (!valid) {
+                return std::nullopt;
+            }
+        }
+
+        return options;
+    }
+
+    /**
+     * @class Random
+     * @brief Быстрый генератор псевдослучайных чисел (xorshift64): у каждого потока свой.
+     */
+    class Random final
+    {
+    public:
+        explicit Random(uint64_t seed) noexcept
+            : state_(seed * 0x9E3779B97F4A7C15ull + 1)
+        {}
+
+        uint64_t operator()() noexcept
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    /**
+     * @brief Выполняет операции с хранилищем в указанном числе потоков.
+     * @return число операций в секунду
+     */
+    double measure(IStorage& storage, const Options& options, size_t threadCount)
+    {
+        // NOTE: Значение короче 16 символов помещается в std::string без выделения памяти.
+        constexpr std::string_view value = "value";
+
+        std::atomic<bool> start = false;
+        std::atomic<size_t> found = 0;
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&, i] {
+                Random random(i + 1);
+                size_t hits = 0;
+
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                for (size_t operation = 0; operation < options.operations; ++operation) {
+                    const uint64_t number = random();
+                    const auto key = static_cast<int>((number >> 8) % options.keys);
+
+                    if (number % 100 < options.writes) {
+                        storage.set(key, value);
+                    } else {
+                        hits += storage.get(key).has_value();
+                    }
+                }
+
+                found.fetch_add(hits, std::memory_order_relaxed);
+            });
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        start.store(true, std::memory_order_release);
+
+        std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        return static_cast<double>(options.operations * threadCount) / seconds;
+    }
+
+    /**
+     * @brief Заполняет половину ключей, чтобы чтения находили как существующие, так и отсутствующие ключи.
+     */
+    void fill(IStorage& storage, const Options& options)
+    {
+        for (size_t key = 0; key < options.keys; key += 2) {
+            storage.set(static_cast<int>(key), "value");
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--threads <max>] [--operations <per thread>] [--writes <percent>] [--keys <count>] [--shards <count>]"
+                  << "\n";
+        return 1;
+    }
+
+    // NOTE: Хранилище из одного сегмента - это одна блокировка на всё хранилище (как в ThreadSafeStorage).
+    struct Variant
+    {
+        std::string name;
+        std::function<std::unique_ptr<IStorage>()> create;
+    };
+
+    const std::vector<Variant> variants = {
+        { "single lock", [] {
+            return std::make_unique<ShardedStorage<MemoryStorage, 1>>();
+        } },
+        { "sharded", [&options] {
+            return (options->shards > 0)
+                ? std::make_unique<ShardedStorage<MemoryStorage>>(options->shards)
+                : std::make_unique<ShardedStorage<MemoryStorage>>();
+        } },
+        { "read-mostly", [] {
+            return std::make_unique<ReadMostlyStorage>();
+        } }
+    };
+
+    std::cout << "Writes: " << options->writes << "%, keys: " << options->keys
+              << ", operations per thread: " << options->operations << "\n"
+              << std::left << std::setw(10) << "threads" << std::setw(16) << "storage" << "ops/s" << "\n";
+
+    // NOTE: Степени двойки и ровно указанное число потоков, даже если оно не степень двойки.
+    std::vector<size_t> threadCounts;
+
+    for (size_t threads = 1; threads < options->threads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+
+    threadCounts.push_back(options->threads);
+
+    for (const size_t threads : threadCounts) {
+        for (const Variant& variant : variants) {
+            const std::unique_ptr<IStorage> storage = variant.create();
+            fill(*storage, *options);
+
+            std::cout << std::setw(10) << threads << std::setw(16) << variant.name
+                      << std::fixed << std::setprecision(0) << measure(*storage, *options, threads) << "\n";
+        }
+    }
+
+    return 0;
+}